@@ -24,6 +24,7 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/point-to-point-layout-module.h"
 #include "ns3/ndnSIM-module.h"
+#include "ns3/ndnSIM/helper/ndn-cs-stats-tracer.hpp"
 #include "ns3/mobility-module.h"
 
 namespace ns3 {
@@ -460,6 +461,7 @@ main(int argc, char* argv[])
   Simulator::Stop(Seconds(20.0));
 
   ndn::AppDelayTracer::InstallAll("Delay.txt");
+  ndn::CsStatsTracer::InstallAll("CsStats.bin", Seconds(1.0), ndn::CsStatsTracer::BINARY);
 
   Simulator::Run();
   Simulator::Destroy();
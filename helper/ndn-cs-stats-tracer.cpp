@@ -0,0 +1,357 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ndn-cs-stats-tracer.hpp"
+
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/names.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+#include "model/ndn-l3-protocol.hpp"
+
+#include "ns3/ndnSIM/NFD/daemon/fw/forwarder.hpp"
+
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+NS_LOG_COMPONENT_DEFINE("ndn.CsStatsTracer");
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+
+/** \brief tracers writing into the same stream, printed by one event per period
+ */
+struct TraceGroup
+{
+  unique_ptr<char[]> buffer; ///< must outlive os
+  shared_ptr<std::ostream> os;
+  std::list<Ptr<CsStatsTracer>> tracers;
+  Time period;
+  EventId printEvent;
+};
+
+/// size of the buffer of trace files, so that samples are written in large blocks
+const size_t TRACE_FILE_BUFFER_SIZE = 1 << 16;
+
+const char BINARY_MAGIC[8] = {'N', 'D', 'N', 'C', 'S', 'S', 'T', '2'};
+
+template<typename T>
+void
+writeBinary(std::ostream& os, const T& value)
+{
+  os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+uint32_t
+saturate(uint64_t value)
+{
+  return static_cast<uint32_t>(std::min<uint64_t>(value, std::numeric_limits<uint32_t>::max()));
+}
+
+} // namespace
+
+static std::list<shared_ptr<TraceGroup>> g_tracers;
+
+static void
+PrintGroup(shared_ptr<TraceGroup> group)
+{
+  for (const auto& tracer : group->tracers) {
+    tracer->Print(*group->os);
+  }
+  group->printEvent = Simulator::Schedule(group->period, &PrintGroup, group);
+}
+
+void
+CsStatsTracer::Destroy()
+{
+  for (const auto& group : g_tracers) {
+    group->printEvent.Cancel();
+    group->os->flush();
+  }
+  g_tracers.clear();
+}
+
+void
+CsStatsTracer::InstallAll(const std::string& file, Time period, Format format)
+{
+  Install(NodeContainer::GetGlobal(), file, period, format);
+}
+
+void
+CsStatsTracer::Install(const NodeContainer& nodes, const std::string& file, Time period,
+                       Format format)
+{
+  auto group = make_shared<TraceGroup>();
+  group->period = period;
+
+  if (file != "-") {
+    shared_ptr<std::ofstream> os(new std::ofstream());
+    group->buffer.reset(new char[TRACE_FILE_BUFFER_SIZE]);
+    os->rdbuf()->pubsetbuf(group->buffer.get(), TRACE_FILE_BUFFER_SIZE);
+
+    std::ios_base::openmode mode = std::ios_base::out | std::ios_base::trunc;
+    if (format == BINARY) {
+      mode |= std::ios_base::binary;
+    }
+    os->open(file.c_str(), mode);
+
+    if (!os->is_open()) {
+      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
+      return;
+    }
+
+    group->os = os;
+  }
+  else {
+    group->os = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  }
+
+  for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
+    if ((*node)->GetObject<L3Protocol>() == nullptr) {
+      NS_LOG_DEBUG("Node " << (*node)->GetId() << " has no NDN stack. Skipping");
+      continue;
+    }
+
+    group->tracers.push_back(Create<CsStatsTracer>(group->os, *node, format));
+  }
+
+  if (format == BINARY) {
+    group->os->write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    writeBinary(*group->os, static_cast<uint32_t>(group->tracers.size()));
+    for (const auto& tracer : group->tracers) {
+      tracer->PrintHeader(*group->os);
+    }
+  }
+  else if (group->tracers.size() > 0) {
+    group->tracers.front()->PrintHeader(*group->os);
+    *group->os << "\n";
+  }
+
+  if (group->tracers.size() > 0) {
+    group->printEvent = Simulator::Schedule(period, &PrintGroup, group);
+  }
+
+  g_tracers.push_back(group);
+}
+
+void
+CsStatsTracer::Install(Ptr<Node> node, const std::string& file, Time period, Format format)
+{
+  Install(NodeContainer(node), file, period, format);
+}
+
+Ptr<CsStatsTracer>
+CsStatsTracer::Install(Ptr<Node> node, shared_ptr<std::ostream> outputStream, Time period,
+                       Format format)
+{
+  NS_LOG_DEBUG("Node: " << node->GetId());
+
+  Ptr<CsStatsTracer> trace = Create<CsStatsTracer>(outputStream, node, format);
+  trace->SetPeriod(period);
+
+  return trace;
+}
+
+CsStatsTracer::CsStatsTracer(shared_ptr<std::ostream> os, Ptr<Node> node, Format format)
+  : m_os(os)
+  , m_format(format)
+  , m_nodePtr(node)
+  , m_lastHits(0)
+  , m_lastMisses(0)
+  , m_lastInserts(0)
+  , m_lastRefreshes(0)
+  , m_lastEvictions(0)
+{
+  m_node = boost::lexical_cast<std::string>(m_nodePtr->GetId());
+
+  std::string name = Names::FindName(node);
+  if (!name.empty()) {
+    m_node = name;
+  }
+}
+
+CsStatsTracer::~CsStatsTracer()
+{
+  m_printEvent.Cancel();
+}
+
+void
+CsStatsTracer::SetPeriod(const Time& period)
+{
+  m_period = period;
+  m_printEvent.Cancel();
+  m_printEvent = Simulator::Schedule(m_period, &CsStatsTracer::PeriodicPrinter, this);
+}
+
+void
+CsStatsTracer::PeriodicPrinter()
+{
+  Print(*m_os);
+  m_printEvent = Simulator::Schedule(m_period, &CsStatsTracer::PeriodicPrinter, this);
+}
+
+void
+CsStatsTracer::PrintHeader(std::ostream& os) const
+{
+  switch (m_format) {
+  case TEXT:
+    os << "Time"
+       << "\t"
+
+       << "Node"
+       << "\t"
+
+       << "Policy"
+       << "\t"
+
+       << "Type"
+       << "\t"
+       << "Value";
+    break;
+  case CSV:
+    os << "Time,Node,Policy,CacheHits,CacheMisses,Inserts,Refreshes,Evictions,Entries,Bytes,"
+       << "Queues";
+    break;
+  case BINARY: {
+    const std::string& policy =
+      m_nodePtr->GetObject<L3Protocol>()->getForwarder()->getCs().getPolicy()->getName();
+    uint8_t policyLength = static_cast<uint8_t>(std::min<size_t>(policy.size(), 255));
+    writeBinary(os, static_cast<uint32_t>(m_nodePtr->GetId()));
+    writeBinary(os, policyLength);
+    os.write(policy.data(), policyLength);
+    break;
+  }
+  }
+}
+
+void
+CsStatsTracer::Print(std::ostream& os)
+{
+  const nfd::cs::CsCounters& counters =
+    m_nodePtr->GetObject<L3Protocol>()->getForwarder()->getCs().getCounters();
+  double time = Simulator::Now().ToDouble(Time::S);
+
+  const uint64_t deltas[5] = {
+    counters.nHits - m_lastHits,
+    counters.nMisses - m_lastMisses,
+    counters.nInserts - m_lastInserts,
+    counters.nRefreshes - m_lastRefreshes,
+    counters.nEvictions - m_lastEvictions
+  };
+
+  switch (m_format) {
+  case TEXT:
+    PrintText(os, time, deltas);
+    break;
+  case CSV:
+    PrintCsv(os, time, deltas);
+    break;
+  case BINARY:
+    PrintBinary(os, time, deltas);
+    break;
+  }
+
+  m_lastHits = counters.nHits;
+  m_lastMisses = counters.nMisses;
+  m_lastInserts = counters.nInserts;
+  m_lastRefreshes = counters.nRefreshes;
+  m_lastEvictions = counters.nEvictions;
+}
+
+void
+CsStatsTracer::PrintText(std::ostream& os, double time, const uint64_t (&deltas)[5]) const
+{
+  const nfd::Cs& cs = m_nodePtr->GetObject<L3Protocol>()->getForwarder()->getCs();
+  const std::string& policy = cs.getPolicy()->getName();
+
+#define PRINTER(type, value)                                 \
+  os << time << "\t" << m_node << "\t" << policy << "\t"   \
+     << type << "\t" << value << "\n";
+
+  PRINTER("CacheHits", deltas[0]);
+  PRINTER("CacheMisses", deltas[1]);
+  PRINTER("Inserts", deltas[2]);
+  PRINTER("Refreshes", deltas[3]);
+  PRINTER("Evictions", deltas[4]);
+  PRINTER("Entries", cs.size());
+  PRINTER("Bytes", cs.byteSize());
+  for (const auto& queue : cs.getPolicy()->getQueueOccupancy()) {
+    PRINTER("Queue:" + queue.first, queue.second);
+  }
+
+#undef PRINTER
+}
+
+void
+CsStatsTracer::PrintCsv(std::ostream& os, double time, const uint64_t (&deltas)[5]) const
+{
+  const nfd::Cs& cs = m_nodePtr->GetObject<L3Protocol>()->getForwarder()->getCs();
+
+  os << time << "," << m_node << "," << cs.getPolicy()->getName();
+  for (uint64_t delta : deltas) {
+    os << "," << delta;
+  }
+  os << "," << cs.size() << "," << cs.byteSize() << ",";
+
+  const char* separator = "";
+  for (const auto& queue : cs.getPolicy()->getQueueOccupancy()) {
+    os << separator << queue.first << ":" << queue.second;
+    separator = ";";
+  }
+  os << "\n";
+}
+
+void
+CsStatsTracer::PrintBinary(std::ostream& os, double time, const uint64_t (&deltas)[5]) const
+{
+  const nfd::Cs& cs = m_nodePtr->GetObject<L3Protocol>()->getForwarder()->getCs();
+
+  writeBinary(os, time);
+  writeBinary(os, static_cast<uint32_t>(m_nodePtr->GetId()));
+  for (uint64_t delta : deltas) {
+    writeBinary(os, saturate(delta));
+  }
+  writeBinary(os, saturate(cs.size()));
+  writeBinary(os, static_cast<uint64_t>(cs.byteSize()));
+
+  // the occupancy section is prefixed with its length, so that readers can skip it
+  std::ostringstream section;
+  size_t sectionLength = 0;
+  for (const auto& queue : cs.getPolicy()->getQueueOccupancy()) {
+    uint8_t nameLength = static_cast<uint8_t>(std::min<size_t>(queue.first.size(), 255));
+    sectionLength += sizeof(nameLength) + nameLength + sizeof(uint32_t);
+    if (sectionLength > std::numeric_limits<uint16_t>::max()) {
+      break;
+    }
+    writeBinary(section, nameLength);
+    section.write(queue.first.data(), nameLength);
+    writeBinary(section, saturate(queue.second));
+  }
+  std::string occupancy = section.str();
+  writeBinary(os, static_cast<uint16_t>(occupancy.size()));
+  os.write(occupancy.data(), occupancy.size());
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,218 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_CS_STATS_TRACER_H
+#define NDN_CS_STATS_TRACER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/node-container.h"
+
+#include <tuple>
+#include <list>
+
+namespace ns3 {
+
+class Node;
+
+namespace ndn {
+
+/**
+ * @ingroup ndn-tracers
+ * @brief Periodically reports counters of NFD's Content Store
+ *
+ * Every period, the tracer writes for each node the number of cache hits, misses, insertions,
+ * refreshes and evictions during the period. It also writes the number of stored packets and
+ * octets at the end of the period. Unlike CsTracer, which follows ndnSIM 1.0 content stores,
+ * this tracer reads counters kept by each node's NFD Content Store, so it works with every NFD
+ * replacement policy.
+ *
+ * Three output formats are supported:
+ * - TEXT: one tab-separated row per counter, like the other ndnSIM tracers
+ * - CSV: one comma-separated row per node and period; the last column "Queues" lists the
+ *   occupancy of each queue as "name:entries" pairs separated by ';', e.g.
+ *   "heap:120;linkedlist:880;stale:0;unsolicited:0"
+ * - BINARY: compact records, see @ref BinaryFormat
+ *
+ * Every format reports the occupancy of each queue of the replacement policy. The set of queues
+ * depends on the policy.
+ *
+ * Sampling only reads counters, so its cost does not depend on the size of the Content Store.
+ * Nodes installed together share one scheduled event per period, and the output file is written
+ * through a large buffer, so tracing hundreds of nodes over long simulations remains cheap.
+ *
+ * @anchor BinaryFormat
+ * A BINARY trace starts with the 8-octet magic "NDNCSST2", a uint32 number of nodes N, and N
+ * node declarations {uint32 node id, uint8 L, L octets of policy name}. It continues with one
+ * record per node and period:
+ *
+ *     offset  size  field
+ *          0     8  double time in seconds
+ *          8     4  uint32 node id
+ *         12     4  uint32 hits
+ *         16     4  uint32 misses
+ *         20     4  uint32 inserts
+ *         24     4  uint32 refreshes
+ *         28     4  uint32 evictions
+ *         32     4  uint32 entries
+ *         36     8  uint64 octets
+ *         44     2  uint16 S, length of the occupancy section
+ *         46     S  occupancy section: one {uint8 L, L octets of queue name, uint32 entries}
+ *                   per queue of the policy
+ *
+ * A reader can skip the occupancy section using S. Per-period counts and queue occupancy
+ * saturate at UINT32_MAX. All fields use host byte order.
+ */
+class CsStatsTracer : public SimpleRefCount<CsStatsTracer> {
+public:
+  enum Format {
+    TEXT,
+    CSV,
+    BINARY
+  };
+
+  /**
+   * @brief Helper method to install tracers on all simulation nodes
+   *
+   * @param file File to which traces will be written.  If filename is -, then std::out is used
+   * @param period How often data will be written into the trace file (default, every second)
+   * @param format Format of the trace file
+   */
+  static void
+  InstallAll(const std::string& file, Time period = Seconds(1.0), Format format = TEXT);
+
+  /**
+   * @brief Helper method to install tracers on the selected simulation nodes
+   *
+   * @param nodes Nodes on which to install tracer
+   * @param file File to which traces will be written.  If filename is -, then std::out is used
+   * @param period How often data will be written into the trace file (default, every second)
+   * @param format Format of the trace file
+   */
+  static void
+  Install(const NodeContainer& nodes, const std::string& file, Time period = Seconds(1.0),
+          Format format = TEXT);
+
+  /**
+   * @brief Helper method to install tracers on a specific simulation node
+   *
+   * @param node Node on which to install tracer
+   * @param file File to which traces will be written.  If filename is -, then std::out is used
+   * @param period How often data will be written into the trace file (default, every second)
+   * @param format Format of the trace file
+   */
+  static void
+  Install(Ptr<Node> node, const std::string& file, Time period = Seconds(1.0),
+          Format format = TEXT);
+
+  /**
+   * @brief Helper method to install tracers on a specific simulation node
+   *
+   * @param node Node on which to install tracer
+   * @param outputStream Smart pointer to a stream
+   * @param period How often data will be written into the trace file (default, every second)
+   * @param format Format of the records; the caller is responsible for the header
+   *
+   * @returns a tracer object associated with the node
+   */
+  static Ptr<CsStatsTracer>
+  Install(Ptr<Node> node, shared_ptr<std::ostream> outputStream, Time period = Seconds(1.0),
+          Format format = TEXT);
+
+  /**
+   * @brief Explicit request to remove all statically created tracers
+   *
+   * This method can be helpful if simulation scenario contains several independent run,
+   * or if it is desired to do a postprocessing of the resulting data
+   */
+  static void
+  Destroy();
+
+  /**
+   * @brief Trace constructor that attaches to the Content Store of the node
+   * @param os    reference to the output stream
+   * @param node  pointer to the node
+   * @param format format of the records
+   */
+  CsStatsTracer(shared_ptr<std::ostream> os, Ptr<Node> node, Format format = TEXT);
+
+  /**
+   * @brief Destructor
+   */
+  ~CsStatsTracer();
+
+  /**
+   * @brief Print head of the trace (e.g., for post-processing)
+   *
+   * In BINARY format, this prints the node declaration of this tracer only.
+   *
+   * @param os reference to output stream
+   */
+  void
+  PrintHeader(std::ostream& os) const;
+
+  /**
+   * @brief Print current trace data, and start a new period
+   *
+   * @param os reference to output stream
+   */
+  void
+  Print(std::ostream& os);
+
+private:
+  void
+  SetPeriod(const Time& period);
+
+  void
+  PeriodicPrinter();
+
+  void
+  PrintText(std::ostream& os, double time, const uint64_t (&deltas)[5]) const;
+
+  void
+  PrintCsv(std::ostream& os, double time, const uint64_t (&deltas)[5]) const;
+
+  void
+  PrintBinary(std::ostream& os, double time, const uint64_t (&deltas)[5]) const;
+
+private:
+  shared_ptr<std::ostream> m_os;
+  Format m_format;
+  std::string m_node;
+  Ptr<Node> m_nodePtr;
+
+  Time m_period;
+  EventId m_printEvent;
+
+  /// counter values at the end of the previous period
+  uint64_t m_lastHits;
+  uint64_t m_lastMisses;
+  uint64_t m_lastInserts;
+  uint64_t m_lastRefreshes;
+  uint64_t m_lastEvictions;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_CS_STATS_TRACER_H
@@ -36,9 +36,12 @@
 #include <boost/lexical_cast.hpp>
 
 #include "ns3/ndnSIM/NFD/daemon/face/generic-link-service.hpp"
+#include "ns3/ndnSIM/NFD/daemon/fw/forwarder.hpp"
 #include "ns3/ndnSIM/NFD/daemon/table/cs-policy-priority-fifo.hpp"
 #include "ns3/ndnSIM/NFD/daemon/table/cs-policy-lru.hpp"
 #include "ns3/ndnSIM/NFD/daemon/table/cs-policy-lrfu.hpp"
+#include "ns3/ndnSIM/NFD/daemon/table/cs-policy-lrfu-size.hpp"
+#include "ns3/ndnSIM/NFD/daemon/table/cs-cache-decisions.hpp"
 
 NS_LOG_COMPONENT_DEFINE("ndn.StackHelper");
 
@@ -52,12 +55,16 @@ StackHelper::StackHelper()
   , m_isStrategyChoiceManagerDisabled(false)
   , m_needSetDefaultRoutes(false)
   , m_maxCsSize(100)
+  , m_csLowWatermark(std::numeric_limits<size_t>::max())
+  , m_maxCsBytes(std::numeric_limits<size_t>::max())
+  , m_csAdmissionWidth(0)
 {
   setCustomNdnCxxClocks();
 
   m_csPolicies.insert({"nfd::cs::lru", [] { return make_unique<nfd::cs::LruPolicy>(); }});
   m_csPolicies.insert({"nfd::cs::priority_fifo", [] () { return make_unique<nfd::cs::PriorityFifoPolicy>(); }});
   m_csPolicies.insert({"nfd::cs::lrfu", [] () { return make_unique<nfd::cs::PriorityLrfuPolicy>(); }});
+  m_csPolicies.insert({"nfd::cs::lrfu_size", [] () { return make_unique<nfd::cs::SizeAwareLrfuPolicy>(); }});
 
   m_csPolicyCreationFunc = m_csPolicies["nfd::cs::lru"];
 
@@ -137,14 +144,92 @@ StackHelper::setCsSize(size_t maxSize)
   m_maxCsSize = maxSize;
 }
 
-// void 
-// StackHelper::setLambda(double lambda)
-// {
-//   LRFUlambda = lambda;
-// }
+void
+StackHelper::setCsLowWatermark(size_t lowWatermark)
+{
+  m_csLowWatermark = lowWatermark;
+}
+
+void
+StackHelper::setCsByteLimit(size_t maxBytes)
+{
+  m_maxCsBytes = maxBytes;
+}
+
+void
+StackHelper::setCsAdmissionFilter(size_t width)
+{
+  m_csAdmissionWidth = width;
+}
+
+/** \brief parses a count attribute
+ *  \throw boost::bad_lexical_cast \p value is not an integer, or is negative
+ *
+ *  lexical_cast<size_t> accepts "-1" and wraps it to SIZE_MAX, so the value is parsed as a
+ *  signed integer first.
+ */
+static size_t
+parseCount(const std::string& value)
+{
+  auto count = boost::lexical_cast<long long>(value);
+  if (count < 0) {
+    throw boost::bad_lexical_cast();
+  }
+  return static_cast<size_t>(count);
+}
+
+void
+StackHelper::setCsDecision(const std::string& decision,
+                           const std::string& attr1, const std::string& value1)
+{
+  if (nfd::cs::CacheDecision::create(decision) == nullptr) {
+    NS_FATAL_ERROR("Cache decision " << decision << " not found");
+  }
+
+  double probability = nfd::cs::ProbDecision::DEFAULT_PROBABILITY;
+  size_t pathLength = nfd::cs::ProbCacheDecision::DEFAULT_PATH_LENGTH;
+  if (attr1 != "") {
+    try {
+      if (attr1 == "Probability" && decision == nfd::cs::ProbDecision::DECISION_NAME) {
+        probability = boost::lexical_cast<double>(value1);
+      }
+      else if (attr1 == "PathLength" && decision == nfd::cs::ProbCacheDecision::DECISION_NAME) {
+        pathLength = parseCount(value1);
+      }
+      else {
+        NS_FATAL_ERROR("Unknown attribute " << attr1 << " of cache decision " << decision);
+      }
+    }
+    catch (const boost::bad_lexical_cast&) {
+      NS_FATAL_ERROR("Invalid value " << value1 << " of attribute " << attr1);
+    }
+  }
+
+  if (probability < 0.0 || probability > 1.0) {
+    NS_FATAL_ERROR("Probability of " << decision << " must be between 0 and 1");
+  }
+  if (pathLength == 0) {
+    NS_FATAL_ERROR("PathLength of " << decision << " must be positive");
+  }
+
+  m_csDecisionCreationFunc = [decision, probability, pathLength] {
+    auto cacheDecision = nfd::cs::CacheDecision::create(decision);
+    if (auto prob = dynamic_cast<nfd::cs::ProbDecision*>(cacheDecision.get())) {
+      prob->setProbability(probability);
+    }
+    else if (auto probCache = dynamic_cast<nfd::cs::ProbCacheDecision*>(cacheDecision.get())) {
+      probCache->setPathLength(pathLength);
+    }
+    return cacheDecision;
+  };
+}
 
 void
-StackHelper::setPolicy(const std::string& policy)
+StackHelper::setPolicy(const std::string& policy,
+                       const std::string& attr1, const std::string& value1,
+                       const std::string& attr2, const std::string& value2,
+                       const std::string& attr3, const std::string& value3,
+                       const std::string& attr4, const std::string& value4)
 {
   auto found = m_csPolicies.find(policy);
   if (found != m_csPolicies.end()) {
@@ -157,6 +242,71 @@ StackHelper::setPolicy(const std::string& policy)
       NS_LOG_DEBUG("    " << it->first);
     }
   }
+
+  std::list<std::pair<std::string, std::string>> attributes;
+  if (attr1 != "")
+    attributes.push_back({attr1, value1});
+  if (attr2 != "")
+    attributes.push_back({attr2, value2});
+  if (attr3 != "")
+    attributes.push_back({attr3, value3});
+  if (attr4 != "")
+    attributes.push_back({attr4, value4});
+
+  if (attributes.empty()) {
+    return;
+  }
+
+  bool isSizeAware = policy == "nfd::cs::lrfu_size";
+  if (policy != "nfd::cs::lrfu" && !isSizeAware) {
+    NS_FATAL_ERROR("Cache replacement policy " << policy << " does not accept attributes");
+  }
+
+  double lambda = nfd::cs::PriorityLrfuPolicy::DEFAULT_LAMBDA;
+  size_t heapSize = nfd::cs::PriorityLrfuPolicy::DEFAULT_HEAP_SIZE;
+  bool useHopCount = false;
+  for (const auto& attribute : attributes) {
+    try {
+      if (attribute.first == "Lambda") {
+        lambda = boost::lexical_cast<double>(attribute.second);
+      }
+      else if (attribute.first == "HeapSize" && !isSizeAware) {
+        heapSize = parseCount(attribute.second);
+      }
+      else if (attribute.first == "HopCost" && isSizeAware) {
+        useHopCount = boost::lexical_cast<bool>(attribute.second);
+      }
+      else {
+        NS_FATAL_ERROR("Unknown attribute " << attribute.first << " of cache replacement policy "
+                       << policy);
+      }
+    }
+    catch (const boost::bad_lexical_cast&) {
+      NS_FATAL_ERROR("Invalid value " << attribute.second << " of attribute " << attribute.first);
+    }
+  }
+
+  if (lambda < 0.0) {
+    NS_FATAL_ERROR("Lambda of " << policy << " must not be negative");
+  }
+  if (heapSize == 0) {
+    NS_FATAL_ERROR("HeapSize of " << policy << " must be positive");
+  }
+
+  m_csPolicyCreationFunc = [isSizeAware, lambda, heapSize, useHopCount] {
+    std::unique_ptr<nfd::cs::PriorityLrfuPolicy> lrfuPolicy;
+    if (isSizeAware) {
+      auto sizeAwarePolicy = make_unique<nfd::cs::SizeAwareLrfuPolicy>();
+      sizeAwarePolicy->setUseHopCount(useHopCount);
+      lrfuPolicy = std::move(sizeAwarePolicy);
+    }
+    else {
+      lrfuPolicy = make_unique<nfd::cs::PriorityLrfuPolicy>();
+    }
+    lrfuPolicy->setLambda(lambda);
+    lrfuPolicy->setHeapSize(heapSize);
+    return lrfuPolicy;
+  };
 }
 
 Ptr<FaceContainer>
@@ -212,12 +362,29 @@ StackHelper::Install(Ptr<Node> node) const
   }
   // if NFD's CS is enabled, check if a replacement policy has been specified
   else {
-    ndn->setCsReplacementPolicy(m_csPolicyCreationFunc);
+    PolicyCreationCallback createPolicy = m_csPolicyCreationFunc;
+    size_t lowWatermark = m_csLowWatermark;
+    ndn->setCsReplacementPolicy([createPolicy, lowWatermark] {
+      auto policy = createPolicy();
+      policy->setLowWatermark(lowWatermark);
+      return policy;
+    });
   }
 
   // Aggregate L3Protocol on node (must be after setting ndnSIM CS)
   node->AggregateObject(ndn);
 
+  if (m_maxCsSize != 0) {
+    nfd::Cs& cs = ndn->getForwarder()->getCs();
+    cs.setByteLimit(m_maxCsBytes);
+    if (m_csAdmissionWidth != 0) {
+      cs.setAdmissionFilter(make_unique<nfd::cs::AdmissionFilter>(m_csAdmissionWidth));
+    }
+    if (m_csDecisionCreationFunc != nullptr) {
+      cs.setCacheDecision(m_csDecisionCreationFunc());
+    }
+  }
+
   for (uint32_t index = 0; index < node->GetNDevices(); index++) {
     Ptr<NetDevice> device = node->GetDevice(index);
     // This check does not make sense: LoopbackNetDevice is installed only if IP stack is installed,
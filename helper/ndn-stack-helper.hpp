@@ -34,6 +34,7 @@
 namespace nfd {
 namespace cs {
 class Policy;
+class CacheDecision;
 } // namespace cs
 } // namespace nfd
 
@@ -80,15 +81,84 @@ public:
   void
   setCsSize(size_t maxSize);
 
+  /**
+   * @brief Set low watermark for NFD's Content Store (in number of packets)
+   *
+   * When the Content Store is full, the replacement policy evicts packets until no more than
+   * @p lowWatermark packets remain, so that eviction happens in batches rather than after
+   * every insertion. By default, the low watermark equals the Content Store size.
+   */
+  void
+  setCsLowWatermark(size_t lowWatermark);
 
-  // void
-  // setLambda(double lambda);
+  /**
+   * @brief Set maximum size for NFD's Content Store (in octets of Data wire encoding)
+   *
+   * The byte limit applies in addition to the limit set with setCsSize(); the replacement
+   * policy evicts packets until both limits are satisfied. By default, there is no byte limit.
+   */
+  void
+  setCsByteLimit(size_t maxBytes);
+
+  /**
+   * @brief Enable TinyLFU admission for NFD's Content Store
+   * @param width number of counters per row of the frequency sketch, 0 to disable admission
+   *
+   * When the Content Store is full, a new Data packet is cached only if its name has been
+   * requested more often than the name of the packet the replacement policy would evict.
+   * This works with every replacement policy. By default, every Data packet is cached.
+   */
+  void
+  setCsAdmissionFilter(size_t width);
+
+  /**
+   * @brief Set the cache decision of NFD's Content Store
+   * @param decision name of the cache decision, one of:
+   *  - "lce": leave-copy-everywhere, every router caches every Data packet (default)
+   *  - "lcd": leave-copy-down, only the router one hop downstream of the content source caches
+   *  - "prob": every router caches with a fixed probability
+   *  - "probcache": the caching probability grows with the distance from the content source
+   *
+   * The distance is counted in hops from the producer, or from the Content Store that
+   * satisfied the Interest. Parameters of the decision can be set with attribute/value pairs:
+   *  - "Probability": caching probability of "prob" (default 0.5)
+   *  - "PathLength": expected number of hops between consumers and content sources,
+   *    for "probcache" (default 5)
+   *
+   * Example:
+   * \code
+   * ndnHelper.setCsDecision("probcache", "PathLength", "6");
+   * \endcode
+   */
+  void
+  setCsDecision(const std::string& decision,
+                const std::string& attr1 = "", const std::string& value1 = "");
 
   /**
    * @brief Set the cache replacement policy for NFD's Content Store
+   * @param policy name of the replacement policy, e.g., "nfd::cs::lrfu"
+   *
+   * Parameters of the policy can be set with attribute/value pairs.
+   * "nfd::cs::lrfu" accepts the following attributes:
+   *  - "Lambda": decay rate of the weighing function (1/2)^(Lambda * t), with t in seconds
+   *    (default 0.1). 0 gives LFU; larger values move the policy towards LRU.
+   *  - "HeapSize": maximum number of entries in the heap part of the policy (default 7)
+   *
+   * "nfd::cs::lrfu_size" evicts the entry with the lowest CRF * cost / size plus GreedyDual
+   * aging, and keeps all entries in its heap. It accepts "Lambda" and:
+   *  - "HopCost": "1" to count the hops travelled by the Data in its cost (default "0")
+   *
+   * Example:
+   * \code
+   * ndnHelper.setPolicy("nfd::cs::lrfu", "Lambda", "0.5", "HeapSize", "100");
+   * \endcode
    */
   void
-  setPolicy(const std::string& policy);
+  setPolicy(const std::string& policy,
+            const std::string& attr1 = "", const std::string& value1 = "",
+            const std::string& attr2 = "", const std::string& value2 = "",
+            const std::string& attr3 = "", const std::string& value3 = "",
+            const std::string& attr4 = "", const std::string& value4 = "");
 
   /**
    * @brief Set ndnSIM 1.0 content store implementation and its attributes
@@ -277,12 +347,18 @@ private:
 
   bool m_needSetDefaultRoutes;
   size_t m_maxCsSize;
+  size_t m_csLowWatermark;
+  size_t m_maxCsBytes;
+  size_t m_csAdmissionWidth;
 
   typedef std::function<std::unique_ptr<nfd::cs::Policy>()> PolicyCreationCallback;
   PolicyCreationCallback m_csPolicyCreationFunc;
 
   std::map<std::string, PolicyCreationCallback> m_csPolicies;
 
+  typedef std::function<std::unique_ptr<nfd::cs::CacheDecision>()> DecisionCreationCallback;
+  DecisionCreationCallback m_csDecisionCreationFunc;
+
   typedef std::list<std::pair<TypeId, FaceCreateCallback>> NetDeviceCallbackList;
   NetDeviceCallbackList m_netDeviceCallbacks;
 };
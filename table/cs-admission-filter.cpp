@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2018,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cs-admission-filter.hpp"
+#include "core/logger.hpp"
+
+#include <algorithm>
+
+namespace nfd {
+namespace cs {
+
+NFD_LOG_INIT("CsAdmissionFilter");
+
+const size_t AdmissionFilter::DEFAULT_WIDTH = 4096;
+const uint8_t AdmissionFilter::MAX_COUNT = 15;
+
+/** \return smallest power of two not less than \p n
+ */
+static size_t
+roundUpToPowerOfTwo(size_t n)
+{
+  size_t result = 1;
+  while (result < n) {
+    result <<= 1;
+  }
+  return result;
+}
+
+AdmissionFilter::AdmissionFilter(size_t width, size_t sampleSize)
+  : m_mask(roundUpToPowerOfTwo(std::max<size_t>(width, 1)) - 1)
+  , m_sampleSize(sampleSize == 0 ? 10 * (m_mask + 1) : sampleSize)
+  , m_nAccesses(0)
+  , m_counters(DEPTH * (m_mask + 1) / 2, 0)
+{
+}
+
+void
+AdmissionFilter::locate(const Name& name, size_t (&positions)[DEPTH]) const
+{
+  uint64_t hash = std::hash<Name>()(name);
+  for (size_t row = 0; row < DEPTH; ++row) {
+    // derive an independent index for each row by mixing the Name hash with the row number
+    uint64_t x = hash + (row + 1) * 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    positions[row] = row * (m_mask + 1) + (static_cast<size_t>(x) & m_mask);
+  }
+}
+
+void
+AdmissionFilter::recordAccess(const Name& name)
+{
+  size_t positions[DEPTH];
+  this->locate(name, positions);
+
+  uint8_t minCount = MAX_COUNT;
+  for (size_t pos : positions) {
+    minCount = std::min(minCount, this->getCount(pos));
+  }
+
+  // conservative update: only the counters that determine the estimate are incremented
+  if (minCount < MAX_COUNT) {
+    for (size_t pos : positions) {
+      if (this->getCount(pos) == minCount) {
+        this->incrementCount(pos);
+      }
+    }
+  }
+
+  if (++m_nAccesses >= m_sampleSize) {
+    this->age();
+  }
+}
+
+uint8_t
+AdmissionFilter::estimate(const Name& name) const
+{
+  size_t positions[DEPTH];
+  this->locate(name, positions);
+
+  uint8_t minCount = MAX_COUNT;
+  for (size_t pos : positions) {
+    minCount = std::min(minCount, this->getCount(pos));
+  }
+  return minCount;
+}
+
+void
+AdmissionFilter::age()
+{
+  NFD_LOG_TRACE("age after " << m_nAccesses << " accesses");
+  // halve both counters of each byte; the mask drops the bit shifted from the high counter
+  for (uint8_t& counts : m_counters) {
+    counts = (counts >> 1) & 0x77;
+  }
+  m_nAccesses = 0;
+}
+
+} // namespace cs
+} // namespace nfd
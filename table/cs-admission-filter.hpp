@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2018,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NFD_DAEMON_TABLE_CS_ADMISSION_FILTER_HPP
+#define NFD_DAEMON_TABLE_CS_ADMISSION_FILTER_HPP
+
+#include "core/common.hpp"
+
+namespace nfd {
+namespace cs {
+
+/** \brief decides whether a new Data packet should displace the next victim of the policy
+ *
+ *  This implements TinyLFU admission: the access frequency of recently requested Names is
+ *  estimated with a count-min sketch of 4-bit counters, and a new Data packet is admitted into
+ *  a full ContentStore only if its Name has been requested more often than the Name of the entry
+ *  the replacement policy would evict first. This keeps Names that are requested only once
+ *  from flushing popular entries out of a small cache.
+ *
+ *  Counters are halved after every sampleSize recorded accesses, so that estimates follow
+ *  changes in popularity.
+ *
+ *  The filter does not depend on the replacement policy; it works with any cs::Policy,
+ *  through Policy::peekVictim().
+ */
+class AdmissionFilter : noncopyable
+{
+public:
+  /** \param width number of counters in each row of the sketch; rounded up to a power of two
+   *  \param sampleSize number of recorded accesses after which all counters are halved;
+   *                    0 selects 10 * width
+   */
+  explicit
+  AdmissionFilter(size_t width = DEFAULT_WIDTH, size_t sampleSize = 0);
+
+  /** \brief records a request for \p name
+   */
+  void
+  recordAccess(const Name& name);
+
+  /** \return estimated number of requests for \p name since the last aging, at most MAX_COUNT
+   */
+  uint8_t
+  estimate(const Name& name) const;
+
+  /** \return whether a Data packet named \p candidate should displace the entry named \p victim
+   */
+  bool
+  shouldAdmit(const Name& candidate, const Name& victim) const
+  {
+    return this->estimate(candidate) > this->estimate(victim);
+  }
+
+  size_t
+  getWidth() const
+  {
+    return m_mask + 1;
+  }
+
+  size_t
+  getSampleSize() const
+  {
+    return m_sampleSize;
+  }
+
+public:
+  static const size_t DEFAULT_WIDTH;
+  static const uint8_t MAX_COUNT;
+
+private:
+  static const size_t DEPTH = 4; ///< number of rows of the sketch
+
+  /** \brief computes the position of \p name in each row of the sketch
+   */
+  void
+  locate(const Name& name, size_t (&positions)[DEPTH]) const;
+
+  /** \return the counter at \p pos
+   */
+  uint8_t
+  getCount(size_t pos) const
+  {
+    return (m_counters[pos >> 1] >> ((pos & 1) << 2)) & MAX_COUNT;
+  }
+
+  /** \brief increments the counter at \p pos
+   *  \pre getCount(pos) < MAX_COUNT
+   */
+  void
+  incrementCount(size_t pos)
+  {
+    m_counters[pos >> 1] += 1 << ((pos & 1) << 2);
+  }
+
+  /** \brief halves every counter
+   */
+  void
+  age();
+
+private:
+  size_t m_mask; ///< width - 1
+  size_t m_sampleSize;
+  size_t m_nAccesses; ///< accesses recorded since the last aging
+  std::vector<uint8_t> m_counters; ///< DEPTH rows of width 4-bit counters, two per byte
+};
+
+} // namespace cs
+} // namespace nfd
+
+#endif // NFD_DAEMON_TABLE_CS_ADMISSION_FILTER_HPP
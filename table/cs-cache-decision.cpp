@@ -0,0 +1,85 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2018,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cs-cache-decision.hpp"
+#include <ndn-cxx/lp/tags.hpp>
+#include <boost/range/adaptor/map.hpp>
+#include <boost/range/algorithm/copy.hpp>
+
+namespace nfd {
+namespace cs {
+
+CacheDecision::Registry&
+CacheDecision::getRegistry()
+{
+  static Registry registry;
+  return registry;
+}
+
+unique_ptr<CacheDecision>
+CacheDecision::create(const std::string& decisionName)
+{
+  Registry& registry = getRegistry();
+  auto i = registry.find(decisionName);
+  return i == registry.end() ? nullptr : i->second();
+}
+
+std::set<std::string>
+CacheDecision::getDecisionNames()
+{
+  std::set<std::string> decisionNames;
+  boost::copy(getRegistry() | boost::adaptors::map_keys,
+              std::inserter(decisionNames, decisionNames.end()));
+  return decisionNames;
+}
+
+CacheDecision::CacheDecision(const std::string& decisionName)
+  : m_decisionName(decisionName)
+{
+}
+
+shared_ptr<const Data>
+CacheDecision::beforeServe(const Data& data)
+{
+  return data.shared_from_this();
+}
+
+shared_ptr<const Data>
+CacheDecision::resetHopCount(const Data& data)
+{
+  auto served = make_shared<Data>(data);
+  served->setTag(make_shared<lp::HopCountTag>(0));
+  return served;
+}
+
+uint64_t
+CacheDecision::getHopCount(const Data& data)
+{
+  shared_ptr<lp::HopCountTag> hopCountTag = data.getTag<lp::HopCountTag>();
+  return hopCountTag == nullptr ? 0 : hopCountTag->get();
+}
+
+} // namespace cs
+} // namespace nfd
@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2018,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NFD_DAEMON_TABLE_CS_CACHE_DECISION_HPP
+#define NFD_DAEMON_TABLE_CS_CACHE_DECISION_HPP
+
+#include "core/common.hpp"
+
+namespace nfd {
+namespace cs {
+
+/** \brief decides whether a router on the forwarding path caches a Data packet
+ *
+ *  Without a cache decision, every router caches every Data packet it forwards
+ *  (leave-copy-everywhere). A cache decision lets routers on a path coordinate, so that
+ *  neighboring ContentStores do not hold duplicates of the same content.
+ *
+ *  Decisions may be based on the distance from the content source, which is the number of hops
+ *  recorded in the HopCountTag of the Data. Such a decision makes a ContentStore that satisfies
+ *  an Interest the content source of the returned Data, see beforeServe().
+ */
+class CacheDecision : noncopyable
+{
+public: // registry
+  template<typename D>
+  static void
+  registerDecision(const std::string& decisionName = D::DECISION_NAME)
+  {
+    Registry& registry = getRegistry();
+    BOOST_ASSERT(registry.count(decisionName) == 0);
+    registry[decisionName] = [] { return make_unique<D>(); };
+  }
+
+  /** \return a cs::CacheDecision identified by \p decisionName,
+   *          or nullptr if \p decisionName is unknown
+   */
+  static unique_ptr<CacheDecision>
+  create(const std::string& decisionName);
+
+  /** \return a list of available cache decision names
+   */
+  static std::set<std::string>
+  getDecisionNames();
+
+public:
+  explicit
+  CacheDecision(const std::string& decisionName);
+
+  virtual
+  ~CacheDecision() = default;
+
+  const std::string&
+  getName() const
+  {
+    return m_decisionName;
+  }
+
+public:
+  /** \brief invoked by CS before inserting a Data packet
+   *  \return whether this router should cache \p data
+   */
+  virtual bool
+  shouldCache(const Data& data) = 0;
+
+  /** \brief invoked by CS before a cached Data packet is used to satisfy an Interest
+   *  \param data the cached Data, which is shared by later hits and must not be modified
+   *  \return the Data to be returned downstream
+   *
+   *  The default implementation returns \p data itself.
+   */
+  virtual shared_ptr<const Data>
+  beforeServe(const Data& data);
+
+protected:
+  /** \return a copy of \p data whose hop count is zero, so that downstream routers measure their
+   *          distance from this ContentStore rather than from the producer
+   *
+   *  The copy shares the wire encoding of \p data; \p data itself is unchanged.
+   */
+  static shared_ptr<const Data>
+  resetHopCount(const Data& data);
+
+  /** \return number of hops \p data has travelled from its content source,
+   *          or 0 if \p data carries no HopCountTag
+   */
+  static uint64_t
+  getHopCount(const Data& data);
+
+private: // registry
+  typedef std::function<unique_ptr<CacheDecision>()> CreateFunc;
+  typedef std::map<std::string, CreateFunc> Registry; // indexed by decision name
+
+  static Registry&
+  getRegistry();
+
+private:
+  std::string m_decisionName;
+};
+
+} // namespace cs
+} // namespace nfd
+
+/** \brief registers a cache decision
+ *  \param D a subclass of nfd::cs::CacheDecision
+ */
+#define NFD_REGISTER_CS_DECISION(D)                      \
+static class NfdAuto ## D ## CsDecisionRegistrationClass \
+{                                                        \
+public:                                                  \
+  NfdAuto ## D ## CsDecisionRegistrationClass()          \
+  {                                                      \
+    ::nfd::cs::CacheDecision::registerDecision<D>();     \
+  }                                                      \
+} g_nfdAuto ## D ## CsDecisionRegistrationVariable
+
+#endif // NFD_DAEMON_TABLE_CS_CACHE_DECISION_HPP
@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2018,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cs-cache-decisions.hpp"
+#include "core/random.hpp"
+
+#include <random>
+
+namespace nfd {
+namespace cs {
+
+const std::string LceDecision::DECISION_NAME = "lce";
+NFD_REGISTER_CS_DECISION(LceDecision);
+
+LceDecision::LceDecision()
+  : CacheDecision(DECISION_NAME)
+{
+}
+
+bool
+LceDecision::shouldCache(const Data& data)
+{
+  return true;
+}
+
+const std::string LcdDecision::DECISION_NAME = "lcd";
+NFD_REGISTER_CS_DECISION(LcdDecision);
+
+LcdDecision::LcdDecision()
+  : CacheDecision(DECISION_NAME)
+{
+}
+
+bool
+LcdDecision::shouldCache(const Data& data)
+{
+  return getHopCount(data) == 1;
+}
+
+shared_ptr<const Data>
+LcdDecision::beforeServe(const Data& data)
+{
+  return resetHopCount(data);
+}
+
+const std::string ProbDecision::DECISION_NAME = "prob";
+NFD_REGISTER_CS_DECISION(ProbDecision);
+
+const double ProbDecision::DEFAULT_PROBABILITY = 0.5;
+
+ProbDecision::ProbDecision()
+  : CacheDecision(DECISION_NAME)
+  , m_probability(DEFAULT_PROBABILITY)
+{
+}
+
+void
+ProbDecision::setProbability(double probability)
+{
+  BOOST_ASSERT(probability >= 0.0 && probability <= 1.0);
+  m_probability = probability;
+}
+
+bool
+ProbDecision::shouldCache(const Data& data)
+{
+  std::bernoulli_distribution dist(m_probability);
+  return dist(getGlobalRng());
+}
+
+const std::string ProbCacheDecision::DECISION_NAME = "probcache";
+NFD_REGISTER_CS_DECISION(ProbCacheDecision);
+
+const size_t ProbCacheDecision::DEFAULT_PATH_LENGTH = 5;
+
+ProbCacheDecision::ProbCacheDecision()
+  : CacheDecision(DECISION_NAME)
+  , m_pathLength(DEFAULT_PATH_LENGTH)
+{
+}
+
+void
+ProbCacheDecision::setPathLength(size_t pathLength)
+{
+  BOOST_ASSERT(pathLength > 0);
+  m_pathLength = pathLength;
+}
+
+bool
+ProbCacheDecision::shouldCache(const Data& data)
+{
+  uint64_t hopCount = getHopCount(data);
+  if (hopCount >= m_pathLength) {
+    return true;
+  }
+
+  std::bernoulli_distribution dist(static_cast<double>(hopCount) / m_pathLength);
+  return dist(getGlobalRng());
+}
+
+shared_ptr<const Data>
+ProbCacheDecision::beforeServe(const Data& data)
+{
+  return resetHopCount(data);
+}
+
+} // namespace cs
+} // namespace nfd
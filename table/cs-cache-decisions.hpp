@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2018,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NFD_DAEMON_TABLE_CS_CACHE_DECISIONS_HPP
+#define NFD_DAEMON_TABLE_CS_CACHE_DECISIONS_HPP
+
+#include "cs-cache-decision.hpp"
+
+namespace nfd {
+namespace cs {
+
+/** \brief leave-copy-everywhere: every router caches every Data
+ */
+class LceDecision : public CacheDecision
+{
+public:
+  LceDecision();
+
+  virtual bool
+  shouldCache(const Data& data) override;
+
+public:
+  static const std::string DECISION_NAME;
+};
+
+/** \brief leave-copy-down: only the router one hop downstream of the content source caches
+ *
+ *  Each hit moves a copy of the content one hop closer to the consumers.
+ */
+class LcdDecision : public CacheDecision
+{
+public:
+  LcdDecision();
+
+  virtual bool
+  shouldCache(const Data& data) override;
+
+  /** \return a copy of \p data with hop count reset, so that the next router caches it
+   */
+  virtual shared_ptr<const Data>
+  beforeServe(const Data& data) override;
+
+public:
+  static const std::string DECISION_NAME;
+};
+
+/** \brief every router caches Data with a fixed probability
+ */
+class ProbDecision : public CacheDecision
+{
+public:
+  ProbDecision();
+
+  virtual bool
+  shouldCache(const Data& data) override;
+
+  double
+  getProbability() const
+  {
+    return m_probability;
+  }
+
+  /** \pre 0 <= probability <= 1
+   */
+  void
+  setProbability(double probability);
+
+public:
+  static const std::string DECISION_NAME;
+
+  static const double DEFAULT_PROBABILITY;
+
+private:
+  double m_probability;
+};
+
+/** \brief ProbCache: the caching probability grows with the distance from the content source
+ *
+ *  A router x hops away from the content source caches with probability min(1, x / c), where c
+ *  is the expected length of the path between consumers and content sources. Copies are
+ *  therefore placed towards the consumers, and routers next to the source rarely duplicate it.
+ *
+ *  This approximates the ProbCache "CacheWeight" term x / c. The "TimesIn" term, which needs
+ *  the cache capacity of the whole path to be carried in Interests, is taken as 1.
+ */
+class ProbCacheDecision : public CacheDecision
+{
+public:
+  ProbCacheDecision();
+
+  virtual bool
+  shouldCache(const Data& data) override;
+
+  /** \return a copy of \p data with hop count reset, so that distance is measured from here
+   */
+  virtual shared_ptr<const Data>
+  beforeServe(const Data& data) override;
+
+  size_t
+  getPathLength() const
+  {
+    return m_pathLength;
+  }
+
+  /** \pre pathLength > 0
+   */
+  void
+  setPathLength(size_t pathLength);
+
+public:
+  static const std::string DECISION_NAME;
+
+  static const size_t DEFAULT_PATH_LENGTH;
+
+private:
+  size_t m_pathLength;
+};
+
+} // namespace cs
+} // namespace nfd
+
+#endif // NFD_DAEMON_TABLE_CS_CACHE_DECISIONS_HPP
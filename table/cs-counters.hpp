@@ -0,0 +1,51 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2018,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NFD_DAEMON_TABLE_CS_COUNTERS_HPP
+#define NFD_DAEMON_TABLE_CS_COUNTERS_HPP
+
+#include "core/counter.hpp"
+
+namespace nfd {
+namespace cs {
+
+/** \brief counters of a ContentStore
+ */
+class CsCounters
+{
+public:
+  PacketCounter nHits;       ///< lookups that found a match
+  PacketCounter nMisses;     ///< lookups that found no match
+  PacketCounter nInserts;    ///< Data admitted as new entries
+  PacketCounter nRefreshes;  ///< Data that refreshed an existing entry
+  PacketCounter nEvictions;  ///< entries evicted by the replacement policy
+  PacketCounter nAdmissionRejects; ///< Data rejected by the admission filter
+  PacketCounter nDeclined;   ///< Data not cached because of the cache decision
+};
+
+} // namespace cs
+} // namespace nfd
+
+#endif // NFD_DAEMON_TABLE_CS_COUNTERS_HPP
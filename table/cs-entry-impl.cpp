@@ -28,28 +28,17 @@
 namespace nfd {
 namespace cs {
 
-EntryImpl::EntryImpl(const Name& name)
-  : m_queryName(name)
-{
-  BOOST_ASSERT(this->isQuery());
-}
-
 EntryImpl::EntryImpl(shared_ptr<const Data> data, bool isUnsolicited)
+  : m_policyInfo(nullptr)
+  , m_leaf(nullptr)
 {
+  BOOST_ASSERT(data != nullptr);
   this->setData(data, isUnsolicited);
-  BOOST_ASSERT(!this->isQuery());
-}
-
-bool
-EntryImpl::isQuery() const
-{
-  return !this->hasData();
 }
 
 void
 EntryImpl::unsetUnsolicited()
 {
-  BOOST_ASSERT(!this->isQuery());
   this->setData(this->getData(), false);
 }
 
@@ -88,22 +77,7 @@ compareDataWithData(const Data& lhs, const Data& rhs)
 bool
 EntryImpl::operator<(const EntryImpl& other) const
 {
-  if (this->isQuery()) {
-    if (other.isQuery()) {
-      return m_queryName < other.m_queryName;
-    }
-    else {
-      return compareQueryWithData(m_queryName, other.getData()) < 0;
-    }
-  }
-  else {
-    if (other.isQuery()) {
-      return compareQueryWithData(other.m_queryName, this->getData()) > 0;
-    }
-    else {
-      return compareDataWithData(this->getData(), other.getData()) < 0;
-    }
-  }
+  return compareDataWithData(this->getData(), other.getData()) < 0;
 }
 
 } // namespace cs
@@ -27,27 +27,39 @@
 #define NFD_DAEMON_TABLE_CS_ENTRY_IMPL_HPP
 
 #include "cs-entry.hpp"
+#include "cs-internal.hpp"
+
+#include <boost/intrusive/list.hpp>
 
 namespace nfd {
 namespace cs {
 
+struct TableLeaf;
+
+/** \brief compares a query Name with the full Name of a Data
+ *  \return negative if \p queryName sorts before \p data, zero if it is the full Name of
+ *          \p data, positive if it sorts after \p data
+ *
+ *  A query Name that does not end with an implicit digest sorts before every Data under it.
+ */
+int
+compareQueryWithData(const Name& queryName, const Data& data);
+
+/** \brief compares two Data by their full Names
+ */
+int
+compareDataWithData(const Data& lhs, const Data& rhs);
+
 /** \brief an Entry in ContentStore implementation
  *
- *  An Entry is either a stored Entry which contains a Data packet and related attributes,
- *  or a query Entry which contains a Name that is LessComparable to other stored/query Entry
- *  and is used to lookup a container of entries.
+ *  An EntryImpl contains a stored Data packet and related attributes. Lookups take a Name,
+ *  and compare it with entries through compareQueryWithData.
  *
  *  \note This type is internal to this specific ContentStore implementation.
  */
-class EntryImpl : public Entry
+class EntryImpl : public Entry, public boost::intrusive::list_base_hook<>
 {
 public:
-  /** \brief construct Entry for query
-   *  \note Name is implicitly convertible to Entry, so that Name can be passed to
-   *        lookup functions on a container of Entry
-   */
-  EntryImpl(const Name& name);
-
   /** \brief construct Entry for storage
    */
   EntryImpl(shared_ptr<const Data> data, bool isUnsolicited);
@@ -58,14 +70,63 @@ public:
   bool
   operator<(const EntryImpl& other) const;
 
-private:
-  bool
-  isQuery() const;
+public: // used by cs::Policy
+  /** \return per-entry state of the replacement policy, or nullptr if none is attached
+   */
+  void*
+  getPolicyInfo() const
+  {
+    return m_policyInfo;
+  }
+
+  /** \brief attaches per-entry state of the replacement policy
+   *
+   *  This lets a policy reach its state of an entry in constant time, without an index keyed
+   *  on Names. The state is owned by the policy and does not take part in entry ordering,
+   *  so it can be changed on a const entry within the Table.
+   */
+  void
+  setPolicyInfo(void* policyInfo) const
+  {
+    m_policyInfo = policyInfo;
+  }
+
+  /** \return size of the stored Data in wire encoding, in octets
+   *  \pre hasData()
+   */
+  size_t
+  getWireSize() const
+  {
+    return this->getData().wireEncode().size();
+  }
+
+  /** \return Table iterator of this entry
+   *  \pre the entry is stored in the Table
+   *
+   *  This lets a policy go from an entry linked in its EntryQueue back to the Table iterator
+   *  in constant time.
+   */
+  iterator
+  getIterator() const
+  {
+    return iterator(this);
+  }
 
 private:
-  Name m_queryName;
+  mutable void* m_policyInfo;
+  mutable TableLeaf* m_leaf; ///< Table leaf holding this entry, maintained by the Table
+
+  friend class Table;
+  friend class TableIterator;
 };
 
+/** \brief a cleanup queue of a replacement policy
+ *
+ *  The links are carried inside each EntryImpl, so that inserting an entry into, or moving it
+ *  between, such queues does not allocate. An entry can be in at most one EntryQueue at a time.
+ */
+typedef boost::intrusive::list<EntryImpl> EntryQueue;
+
 } // namespace cs
 } // namespace nfd
 
@@ -127,6 +127,15 @@ public: // used by generic ContentStore implementation
   void
   updateStaleTime();
 
+  /** \brief sets stale time, e.g. to restore an entry that has part of its freshness period left
+   */
+  void
+  setStaleTime(const time::steady_clock::TimePoint& staleTime)
+  {
+    BOOST_ASSERT(this->hasData());
+    m_staleTime = staleTime;
+  }
+
   /** \brief clears the entry
    *  \post !hasData()
    */
@@ -36,9 +36,97 @@ namespace nfd {
 namespace cs {
 
 class EntryImpl;
+class Table;
 
-typedef std::set<EntryImpl> Table;
-typedef Table::const_iterator iterator;
+/** \brief Table iterator, in the order of full Names
+ *
+ *  An iterator refers to an entry rather than to a position in the Table: it stays valid,
+ *  and keeps referring to the same entry, across insertions and erasures of other entries.
+ *  Policies, the exact Name index, and each EntryImpl rely on this.
+ */
+class TableIterator : public std::iterator<std::bidirectional_iterator_tag, const EntryImpl>
+{
+public:
+  /** \brief constructs a singular iterator
+   */
+  TableIterator()
+    : m_table(nullptr)
+    , m_entry(nullptr)
+    , m_pos(0)
+  {
+  }
+
+  const EntryImpl&
+  operator*() const
+  {
+    BOOST_ASSERT(m_entry != nullptr);
+    return *m_entry;
+  }
+
+  const EntryImpl*
+  operator->() const
+  {
+    BOOST_ASSERT(m_entry != nullptr);
+    return m_entry;
+  }
+
+  TableIterator&
+  operator++();
+
+  TableIterator
+  operator++(int)
+  {
+    TableIterator copy(*this);
+    ++*this;
+    return copy;
+  }
+
+  TableIterator&
+  operator--();
+
+  TableIterator
+  operator--(int)
+  {
+    TableIterator copy(*this);
+    --*this;
+    return copy;
+  }
+
+  bool
+  operator==(const TableIterator& other) const
+  {
+    return m_entry == other.m_entry;
+  }
+
+  bool
+  operator!=(const TableIterator& other) const
+  {
+    return !this->operator==(other);
+  }
+
+private:
+  TableIterator(const Table* table, const EntryImpl* entry, size_t pos)
+    : m_table(table)
+    , m_entry(entry)
+    , m_pos(pos)
+  {
+  }
+
+  /** \brief constructs an iterator to a stored entry
+   */
+  explicit
+  TableIterator(const EntryImpl* entry);
+
+private:
+  const Table* m_table;
+  const EntryImpl* m_entry; ///< nullptr for the past-the-end iterator
+  size_t m_pos; ///< position of m_entry in its leaf when the iterator was made; only a hint
+
+  friend class Table;
+  friend class EntryImpl;
+};
+
+typedef TableIterator iterator;
 
 } // namespace cs
 } // namespace nfd
@@ -0,0 +1,58 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2018,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cs-policy-lrfu-size.hpp"
+#include <ndn-cxx/lp/tags.hpp>
+
+namespace nfd {
+namespace cs {
+namespace lrfu {
+
+const std::string SizeAwareLrfuPolicy::POLICY_NAME = "lrfu_size";
+NFD_REGISTER_CS_POLICY(SizeAwareLrfuPolicy);
+
+SizeAwareLrfuPolicy::SizeAwareLrfuPolicy()
+  : PriorityLrfuPolicy(POLICY_NAME, true)
+  , m_useHopCount(false)
+{
+}
+
+double
+SizeAwareLrfuPolicy::getEntryWeight(iterator i) const
+{
+  double cost = 1.0;
+  if (m_useHopCount) {
+    shared_ptr<lp::HopCountTag> hopCountTag = i->getData().getTag<lp::HopCountTag>();
+    if (hopCountTag != nullptr) {
+      cost += hopCountTag->get();
+    }
+  }
+
+  return cost / std::max<size_t>(i->getWireSize(), 1);
+}
+
+} // namespace lrfu
+} // namespace cs
+} // namespace nfd
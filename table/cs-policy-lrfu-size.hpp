@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2018,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NFD_DAEMON_TABLE_CS_POLICY_LRFU_SIZE_HPP
+#define NFD_DAEMON_TABLE_CS_POLICY_LRFU_SIZE_HPP
+
+#include "cs-policy-lrfu.hpp"
+
+namespace nfd {
+namespace cs {
+namespace lrfu {
+
+/** \brief size-aware LRFU cs replacement policy
+ *
+ *  This policy is GreedyDual-Size with CRF as frequency: after unsolicited and stale entries,
+ *  the victim is the entry with the lowest L + CRF * cost / size, where size is the wire size
+ *  of the Data and cost is the cost of fetching it again.
+ *  A small entry that is referenced often is kept in preference to a large entry with a
+ *  similar CRF, which makes better use of the cache in octets.
+ *  L is the priority of the last such victim, and is taken by an entry whenever it is inserted
+ *  or referenced, so that entries which stop being referenced age out.
+ *
+ *  All solicited fresh entries are kept in the heap, so the heap size does not apply.
+ *
+ *  The cost is 1 by default. If hop-count cost is enabled, the cost is 1 plus the number of
+ *  hops the Data has travelled, as recorded in its HopCountTag.
+ */
+class SizeAwareLrfuPolicy : public PriorityLrfuPolicy
+{
+public:
+  SizeAwareLrfuPolicy();
+
+public:
+  static const std::string POLICY_NAME;
+
+public:
+  /** \brief gets whether the cost of an entry reflects its hop count
+   */
+  bool
+  getUseHopCount() const
+  {
+    return m_useHopCount;
+  }
+
+  /** \brief sets whether the cost of an entry reflects its hop count
+   *
+   *  The setting applies to entries inserted afterwards.
+   */
+  void
+  setUseHopCount(bool useHopCount)
+  {
+    m_useHopCount = useHopCount;
+  }
+
+protected:
+  virtual double
+  getEntryWeight(iterator i) const override;
+
+private:
+  bool m_useHopCount;
+};
+
+} // namespace lrfu
+
+using lrfu::SizeAwareLrfuPolicy;
+
+} // namespace cs
+} // namespace nfd
+
+#endif // NFD_DAEMON_TABLE_CS_POLICY_LRFU_SIZE_HPP
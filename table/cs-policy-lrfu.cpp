@@ -30,7 +30,7 @@
 #include "cs-policy-lrfu.hpp"
 #include "cs.hpp"
 #include "core/logger.hpp"
-#include "math.h"
+#include <cmath>
 
 NFD_LOG_INIT("LrfuPolicy");
 
@@ -41,262 +41,599 @@ namespace lrfu {
 const std::string PriorityLrfuPolicy::POLICY_NAME = "lrfu";
 NFD_REGISTER_CS_POLICY(PriorityLrfuPolicy);
 
-PriorityLrfuPolicy::PriorityLrfuPolicy()
-  : Policy(POLICY_NAME)
+const double PriorityLrfuPolicy::DEFAULT_LAMBDA = 0.1;
+const size_t PriorityLrfuPolicy::DEFAULT_HEAP_SIZE = 7;
+
+/** \brief when reference weights grow beyond 2^RENORMALIZE_EXPONENT, all scaled CRF values
+ *         are rebased onto a later epoch
+ */
+static const int RENORMALIZE_EXPONENT = 512;
+
+#if NFD_CS_LRFU_TRACE
+#define LRFU_TRACE(type, i, entryInfo) this->trace(TraceEventType::type, i, entryInfo)
+#else
+#define LRFU_TRACE(type, i, entryInfo) do {} while (false)
+#endif // NFD_CS_LRFU_TRACE
+
+/** \return \p timePoint in seconds
+ */
+static double
+toSeconds(const time::steady_clock::TimePoint& timePoint)
 {
+  ndn::time::milliseconds milliseconds = ::ndn::time::duration_cast<::ndn::time::milliseconds>(timePoint.time_since_epoch());
+  double time_ms = milliseconds.count();
+  return time_ms / 1000;
 }
 
-PriorityLrfuPolicy::~PriorityLrfuPolicy()
+/** \return current time in seconds
+ */
+static double
+getCurrentTime()
+{
+  return toSeconds(::ndn::time::steady_clock::now());
+}
+
+std::ostream&
+operator<<(std::ostream& os, QueueType queueType)
+{
+  switch (queueType) {
+    case unsolicited:
+      return os << "unsolicited";
+    case stale:
+      return os << "stale";
+    case heaplist:
+      return os << "heap";
+    case linkedlist:
+      return os << "linkedlist";
+    case lrfu:
+      return os << "lrfu";
+  }
+  return os << static_cast<int>(queueType);
+}
+
+std::ostream&
+operator<<(std::ostream& os, TraceEventType type)
 {
-  for (auto entryInfoMapPair : m_entryInfoMap) {
-    delete entryInfoMapPair.second;
+  switch (type) {
+    case TraceEventType::INSERT:
+      return os << "insert";
+    case TraceEventType::REFERENCE:
+      return os << "reference";
+    case TraceEventType::PROMOTE:
+      return os << "promote";
+    case TraceEventType::DEMOTE:
+      return os << "demote";
+    case TraceEventType::STALE:
+      return os << "stale";
+    case TraceEventType::EVICT:
+      return os << "evict";
   }
+  return os << static_cast<int>(type);
 }
 
-//Not Yet
 void
-PriorityLrfuPolicy::doBeforeErase(iterator i)
+CrfHeap::push(EntryInfo* info)
 {
-  NFD_LOG_INFO("Before Erase Function" );
+  m_heap.push_back(info);
+  info->heapIndex = m_heap.size() - 1;
+  this->siftUp(info->heapIndex);
+}
 
-  this->detachQueue(i);
+void
+CrfHeap::erase(EntryInfo* info)
+{
+  size_t pos = info->heapIndex;
+  BOOST_ASSERT(pos < m_heap.size() && m_heap[pos] == info);
+
+  EntryInfo* last = m_heap.back();
+  m_heap.pop_back();
+  if (last == info) {
+    return;
+  }
+
+  this->place(pos, last);
+  this->update(last);
 }
 
 void
-PriorityLrfuPolicy::doAfterRefresh(iterator i)
+CrfHeap::update(EntryInfo* info)
 {
-  NFD_LOG_INFO("After Refresh Function" );
+  size_t pos = info->heapIndex;
+  BOOST_ASSERT(pos < m_heap.size() && m_heap[pos] == info);
 
-  EntryInfo* entryInfo = m_entryInfoMap[i];
+  if (pos > 0 && info->getPriority() < m_heap[(pos - 1) / 2]->getPriority()) {
+    this->siftUp(pos);
+  }
+  else {
+    this->siftDown(pos);
+  }
+}
 
-  if(entryInfo->queueType == linkedlist){
-    NFD_LOG_INFO("Linked List Location");
-    this->updateCRF(i);
-    this->restoreHeapStructure(true);
-    this->moveToHeapList(i);
+void
+CrfHeap::siftUp(size_t pos)
+{
+  EntryInfo* info = m_heap[pos];
+  while (pos > 0) {
+    size_t parent = (pos - 1) / 2;
+    if (!(info->getPriority() < m_heap[parent]->getPriority())) {
+      break;
+    }
+    this->place(pos, m_heap[parent]);
+    pos = parent;
+  }
+  this->place(pos, info);
+}
+
+void
+CrfHeap::siftDown(size_t pos)
+{
+  EntryInfo* info = m_heap[pos];
+  size_t n = m_heap.size();
+  while (true) {
+    size_t child = 2 * pos + 1;
+    if (child >= n) {
+      break;
+    }
+    if (child + 1 < n && m_heap[child + 1]->getPriority() < m_heap[child]->getPriority()) {
+      ++child;
+    }
+    if (!(m_heap[child]->getPriority() < info->getPriority())) {
+      break;
+    }
+    this->place(pos, m_heap[child]);
+    pos = child;
   }
+  this->place(pos, info);
+}
+
+PriorityLrfuPolicy::PriorityLrfuPolicy()
+  : PriorityLrfuPolicy(POLICY_NAME, false)
+{
+}
 
-  else if (entryInfo->queueType == heaplist){
-    NFD_LOG_INFO("Already in HeapList");
-    this->updateCRF(i);
-    this->restoreHeapStructure(false);
+PriorityLrfuPolicy::PriorityLrfuPolicy(const std::string& policyName, bool isCostAware)
+  : Policy(policyName)
+  , m_isCostAware(isCostAware)
+  , m_lambda(DEFAULT_LAMBDA)
+  , m_heapSize(DEFAULT_HEAP_SIZE)
+  , m_inflation(0.0)
+  , m_epoch(getCurrentTime())
+  , m_weightTime(m_epoch)
+  , m_weight(1.0)
+{
+}
+
+PriorityLrfuPolicy::~PriorityLrfuPolicy()
+{
+  auto disposeEntryInfo = [this] (EntryInfo* entryInfo) {
+    if (entryInfo->queueType == heaplist || entryInfo->queueType == linkedlist) {
+      scheduler::cancel(entryInfo->moveListEventId);
+    }
+    entryInfo->entryIt->setPolicyInfo(nullptr);
+    m_entryInfoPool.destroy(entryInfo);
+  };
+  auto disposeEntry = [&] (EntryImpl* entry) {
+    disposeEntryInfo(static_cast<EntryInfo*>(entry->getPolicyInfo()));
+  };
+
+  m_unsolicitedList.clear_and_dispose(disposeEntry);
+  m_staleList.clear_and_dispose(disposeEntry);
+  m_linkedList.clear_and_dispose(disposeEntry);
+  for (EntryInfo* entryInfo : m_heap) {
+    disposeEntryInfo(entryInfo);
   }
-  
 }
 
+Policy::QueueOccupancy
+PriorityLrfuPolicy::getQueueOccupancy() const
+{
+  return {{"unsolicited", m_unsolicitedList.size()},
+          {"stale", m_staleList.size()},
+          {"heap", m_heap.size()},
+          {"linkedlist", m_linkedList.size()}};
+}
 
 void
-PriorityLrfuPolicy::doAfterInsert(iterator i)
+PriorityLrfuPolicy::setLambda(double lambda)
 {
-  NFD_LOG_INFO("After Insert Function" );
+  BOOST_ASSERT(lambda >= 0.0);
+  NFD_LOG_INFO("setLambda " << lambda);
+
+  // scaled values of existing entries are only meaningful under the old lambda:
+  // rebase them onto the current time, where scaled CRF equals actual CRF
+  double currentTime = getCurrentTime();
+  double scale = std::exp2(-m_lambda * (currentTime - m_epoch));
+  this->forEachEntryInfo([scale] (EntryInfo* entryInfo) {
+    entryInfo->crf *= scale;
+    entryInfo->inflation *= scale;
+  });
+  m_inflation *= scale;
+  m_epoch = m_weightTime = currentTime;
+  m_weight = 1.0;
+  m_lambda = lambda;
+}
 
-  this->attachQueue(i);
-  this->evictEntries();
+void
+PriorityLrfuPolicy::setHeapSize(size_t heapSize)
+{
+  BOOST_ASSERT(heapSize > 0);
+  NFD_LOG_INFO("setHeapSize " << heapSize);
+
+  m_heapSize = heapSize;
+  while (!m_isCostAware && m_heap.size() > m_heapSize) {
+    this->demoteHeapTop();
+  }
 }
 
+#if NFD_CS_LRFU_TRACE
 void
-PriorityLrfuPolicy::doBeforeUse(iterator i)
+PriorityLrfuPolicy::trace(TraceEventType type, iterator i, const EntryInfo* entryInfo)
 {
-  NFD_LOG_INFO("Before Use Function" );
+  TraceEvent event{type, i, entryInfo->queueType, this->getCrf(entryInfo, getCurrentTime())};
+  NFD_LOG_TRACE(event.type << " " << i->getName() << " queue=" << event.queueType <<
+                " crf=" << event.crf);
+  this->emitSignal(afterTraceEvent, event);
+}
+#endif // NFD_CS_LRFU_TRACE
 
-  EntryInfo* entryInfo = m_entryInfoMap[i];
+double
+PriorityLrfuPolicy::getEntryWeight(iterator i) const
+{
+  return 1.0;
+}
 
-  if(entryInfo->queueType == linkedlist){
-    NFD_LOG_INFO("Linked List Location");
-    this->updateCRF(i);
-    this->restoreHeapStructure(true);
-    this->moveToHeapList(i);
+void
+PriorityLrfuPolicy::doBeforeErase(iterator i)
+{
+  this->detachQueue(i);
+}
+
+void
+PriorityLrfuPolicy::doAfterRefresh(iterator i)
+{
+  EntryInfo* entryInfo = getEntryInfo<EntryInfo>(i);
+  if (entryInfo->queueType == heaplist || entryInfo->queueType == linkedlist) {
+    scheduler::cancel(entryInfo->moveListEventId);
+    this->referenceEntry(i);
+    this->scheduleMoveToStaleList(i, entryInfo);
+    return;
   }
 
-  else if (entryInfo->queueType == heaplist){
-    NFD_LOG_INFO("Already in HeapList");
-    this->updateCRF(i);
-    this->restoreHeapStructure(false);
+  // the refreshing Data may have made an unsolicited or stale entry solicited and fresh
+  this->updateCRF(i);
+  LRFU_TRACE(REFERENCE, i, entryInfo);
+  Queue& queue = entryInfo->queueType == unsolicited ? m_unsolicitedList : m_staleList;
+  queue.erase(queue.iterator_to(*i));
+  if (!this->attachPriorityQueue(i, entryInfo)) {
+    this->insertToHeap(entryInfo);
+    this->scheduleMoveToStaleList(i, entryInfo);
   }
+}
 
+double
+PriorityLrfuPolicy::getEntryScore(iterator i) const
+{
+  BOOST_ASSERT(i->getPolicyInfo() != nullptr);
+  return this->getCrf(getEntryInfo<EntryInfo>(i), getCurrentTime());
 }
 
 void
-PriorityLrfuPolicy::evictEntries()
+PriorityLrfuPolicy::doAfterLoad(iterator i, double score)
 {
-  BOOST_ASSERT(this->getCs() != nullptr);
+  BOOST_ASSERT(i->getPolicyInfo() == nullptr);
+
+  // without a previous CRF, score the entry as if it had been referenced once, when it was last
+  // inserted or refreshed; entries are loaded from the oldest, so the heap keeps the most recent
+  double currentTime = getCurrentTime();
+  double referencedTime = toSeconds(i->getStaleTime() -
+                                    time::milliseconds(i->getData().getFreshnessPeriod()));
+  EntryInfo* entryInfo = this->createEntryInfo(i, std::min(referencedTime, currentTime));
+  if (score > 0.0) {
+    entryInfo->crf = score * this->getReferenceWeight(currentTime);
+  }
 
-  while (this->getCs()->size() > this->getLimit()) {
-    this->evictOne();
+  if (!this->attachPriorityQueue(i, entryInfo)) {
+    this->insertToHeap(entryInfo);
+    this->scheduleMoveToStaleList(i, entryInfo);
   }
+  LRFU_TRACE(INSERT, i, entryInfo);
 }
 
 void
-PriorityLrfuPolicy::evictOne()
+PriorityLrfuPolicy::doAfterInsert(iterator i)
+{
+  this->attachQueue(i);
+  this->evictEntries();
+}
+
+void
+PriorityLrfuPolicy::doBeforeUse(iterator i)
+{
+  this->referenceEntry(i);
+}
+
+iterator
+PriorityLrfuPolicy::peekVictim() const
 {
-  BOOST_ASSERT(!m_queues[heaplist].empty()||
-               !m_queues[linkedlist].empty());
+  BOOST_ASSERT(!m_unsolicitedList.empty() ||
+               !m_staleList.empty() ||
+               !m_heap.empty() ||
+               !m_linkedList.empty());
 
-   iterator i;
-    if(!m_queues[linkedlist].empty()){
-       i = m_queues[linkedlist].front();
-     }
+  if (!m_unsolicitedList.empty()) {
+    return m_unsolicitedList.front().getIterator();
+  }
+  if (!m_staleList.empty()) {
+    return m_staleList.front().getIterator();
+  }
+  if (!m_linkedList.empty()) {
+    return m_linkedList.front().getIterator();
+  }
+  return m_heap.top()->entryIt;
+}
 
-   this->detachQueue(i);
-   this->emitSignal(beforeEvict, i);
+iterator
+PriorityLrfuPolicy::selectVictim()
+{
+  iterator i = this->peekVictim();
+  EntryInfo* entryInfo = getEntryInfo<EntryInfo>(i);
+  LRFU_TRACE(EVICT, i, entryInfo);
+  if (m_isCostAware && entryInfo->queueType == heaplist) {
+    // GreedyDual aging: entries referenced from now on start from the victim's priority
+    m_inflation = entryInfo->getPriority();
+  }
+  this->detachQueue(i);
+  return i;
 }
 
 void
 PriorityLrfuPolicy::attachQueue(iterator i)
 {
-  BOOST_ASSERT(m_entryInfoMap.find(i) == m_entryInfoMap.end());
+  BOOST_ASSERT(i->getPolicyInfo() == nullptr);
 
-  ndn::time::steady_clock::TimePoint init_now = ::ndn::time::steady_clock::now();
-  ndn::time::milliseconds init_milliseconds = ::ndn::time::duration_cast<::ndn::time::milliseconds>(init_now.time_since_epoch());
-  double init_time_ms = init_milliseconds.count();
-  double init_currentTime = init_time_ms/1000;
+  EntryInfo* entryInfo = this->createEntryInfo(i, getCurrentTime());
 
-  EntryInfo* entryInfo = new EntryInfo();
-    entryInfo->crf = 1.0;
-    entryInfo->lastReferencedTime=init_currentTime;
+  if (this->attachPriorityQueue(i, entryInfo)) {
+    LRFU_TRACE(INSERT, i, entryInfo);
+    return;
+  }
 
-    if(this->getCs()->size() == this->getLimit()+1){
-      NFD_LOG_INFO("** New Interest **");
-      this->restoreHeapStructure(true);
-      entryInfo->queueType = heaplist;
-    }
-    else if (this->getCs()->size() > 7) {
-      entryInfo->queueType = linkedlist;
-      NFD_LOG_INFO("Type : LinkedList");
-    }
-    else{
-      entryInfo->queueType = heaplist;
-      NFD_LOG_INFO("Type : HeapList");
+  // When this insertion makes evictEntries() evict, whether because of the hard limit or the
+  // byte limit, the new entry enters the heap and the heap top is demoted in its place, so that
+  // the batch is taken from the linked list before the new entry.
+  // A cost-aware heap holds every entry, and the new entry competes with them for eviction.
+  if (!m_isCostAware && this->needsEviction()) {
+    if (!m_heap.empty()) {
+      this->demoteHeapTop();
     }
+    entryInfo->queueType = heaplist;
+    m_heap.push(entryInfo);
+  }
+  else if (this->isHeapFull()) {
+    entryInfo->queueType = linkedlist;
+    m_linkedList.push_back(getQueueEntry(i));
+  }
+  else {
+    entryInfo->queueType = heaplist;
+    m_heap.push(entryInfo);
+  }
+  this->scheduleMoveToStaleList(i, entryInfo);
 
-  Queue& queue = m_queues[entryInfo->queueType];
-  entryInfo->queueIt = queue.insert(queue.end(), i);
-  m_entryInfoMap[i] = entryInfo;
-
-  for(auto it = m_queues[heaplist].begin(); it != m_queues[heaplist].end(); ++it)
-     {
-      if(m_entryInfoMap[*it]->queueType == heaplist){
-      NFD_LOG_INFO("EntryInfo HeapList " << m_entryInfoMap[*it]);
-     }
-  }
- 
-  for(auto it = m_queues[linkedlist].begin(); it != m_queues[linkedlist].end(); ++it)
-  {
-    if(m_entryInfoMap[*it]->queueType == linkedlist){
-    NFD_LOG_INFO("EntryInfo LinkedList " << m_entryInfoMap[*it]);
-    }
-  }          
+  LRFU_TRACE(INSERT, i, entryInfo);
+}
 
+EntryInfo*
+PriorityLrfuPolicy::createEntryInfo(iterator i, double referencedTime)
+{
+  EntryInfo* entryInfo = m_entryInfoPool.construct();
+  entryInfo->crf = this->getReferenceWeight(referencedTime);
+  entryInfo->weight = this->getEntryWeight(i);
+  entryInfo->inflation = m_inflation;
+  entryInfo->lastReferencedTime = referencedTime;
+  entryInfo->entryIt = i;
+  i->setPolicyInfo(entryInfo);
+  return entryInfo;
+}
 
-  NFD_LOG_DEBUG("Size: "<< this->getCs()->size() <<"CRF : "<< m_entryInfoMap[i]->crf << ", entryInfo: "<< m_entryInfoMap[i]);
+/** \return whether the Data of the entry has a FreshnessPeriod, after which it becomes stale
+ *
+ *  Data without FreshnessPeriod is stale from the start, but is managed by LRFU rather than by
+ *  the stale list; see PriorityLrfuPolicy.
+ */
+static bool
+hasFreshnessPeriod(iterator i)
+{
+  return i->getData().getFreshnessPeriod() > time::milliseconds::zero();
+}
 
+void
+PriorityLrfuPolicy::scheduleMoveToStaleList(iterator i, EntryInfo* entryInfo)
+{
+  if (!hasFreshnessPeriod(i)) {
+    return;
+  }
+  entryInfo->moveListEventId = scheduler::schedule(i->getStaleTime() - time::steady_clock::now(),
+                                                   [=] { moveToStaleList(i); });
 }
 
 void
 PriorityLrfuPolicy::detachQueue(iterator i)
 {
-  BOOST_ASSERT(m_entryInfoMap.find(i) != m_entryInfoMap.end());
-
-  EntryInfo* entryInfo = m_entryInfoMap[i];
-
-  m_queues[entryInfo->queueType].erase(entryInfo->queueIt);
+  BOOST_ASSERT(i->getPolicyInfo() != nullptr);
+
+  EntryInfo* entryInfo = getEntryInfo<EntryInfo>(i);
+
+  switch (entryInfo->queueType) {
+    case unsolicited:
+      m_unsolicitedList.erase(m_unsolicitedList.iterator_to(*i));
+      break;
+    case stale:
+      m_staleList.erase(m_staleList.iterator_to(*i));
+      break;
+    case heaplist:
+      scheduler::cancel(entryInfo->moveListEventId);
+      m_heap.erase(entryInfo);
+      break;
+    case linkedlist:
+      scheduler::cancel(entryInfo->moveListEventId);
+      m_linkedList.erase(m_linkedList.iterator_to(*i));
+      break;
+    default:
+      BOOST_ASSERT(false);
+      break;
+  }
 
-  NFD_LOG_DEBUG("Erased " << m_entryInfoMap[i]);
-  m_entryInfoMap.erase(i);
-  delete entryInfo;
+  i->setPolicyInfo(nullptr);
+  m_entryInfoPool.destroy(entryInfo);
+}
 
+bool
+PriorityLrfuPolicy::attachPriorityQueue(iterator i, EntryInfo* entryInfo)
+{
+  if (i->isUnsolicited()) {
+    entryInfo->queueType = unsolicited;
+    m_unsolicitedList.push_back(getQueueEntry(i));
+    return true;
+  }
+  if (i->isStale() && hasFreshnessPeriod(i)) {
+    entryInfo->queueType = stale;
+    m_staleList.push_back(getQueueEntry(i));
+    return true;
+  }
+  return false;
 }
 
 void
 PriorityLrfuPolicy::updateCRF(iterator i)
 {
-  BOOST_ASSERT(m_entryInfoMap.find(i) != m_entryInfoMap.end());
-
-  EntryInfo* entryInfo = m_entryInfoMap[i];
+  BOOST_ASSERT(i->getPolicyInfo() != nullptr);
 
-  double initTime = entryInfo->lastReferencedTime;
-  double lastCrf = entryInfo->crf;
+  EntryInfo* entryInfo = getEntryInfo<EntryInfo>(i);
 
-  ndn::time::steady_clock::TimePoint now = ::ndn::time::steady_clock::now();
-  ndn::time::milliseconds milliseconds = ::ndn::time::duration_cast<::ndn::time::milliseconds>(now.time_since_epoch());
-  double time_ms = milliseconds.count();
-  double currentTime = time_ms/1000;
+  double currentTime = getCurrentTime();
 
-  double newReferencedTime = currentTime - initTime;
-
-  entryInfo->crf = 1.0 + pow((1.0/2.0),(0.1 * newReferencedTime)) * lastCrf;
+  // C(t) = 1 + F(t - t_last) * C(t_last) becomes a single addition in the scaled domain
+  entryInfo->crf += this->getReferenceWeight(currentTime);
+  entryInfo->inflation = m_inflation;
   entryInfo->lastReferencedTime = currentTime;
+}
 
-  NFD_LOG_DEBUG("Update CRF : "<< m_entryInfoMap[i]->crf << " New Referenced: " <<m_entryInfoMap[i]->lastReferencedTime);
-  NFD_LOG_DEBUG("currentTime: " <<currentTime << " CRF: " << lastCrf << " lastReferencedTime: " <<initTime);
+double
+PriorityLrfuPolicy::getReferenceWeight(double currentTime)
+{
+  if (currentTime == m_weightTime) {
+    return m_weight;
+  }
 
+  double exponent = m_lambda * (currentTime - m_epoch);
+  if (exponent > RENORMALIZE_EXPONENT) {
+    this->renormalize(static_cast<int>(exponent));
+    exponent = m_lambda * (currentTime - m_epoch);
+  }
+
+  m_weightTime = currentTime;
+  m_weight = std::exp2(exponent);
+  return m_weight;
 }
 
 void
-PriorityLrfuPolicy::restoreHeapStructure(bool status)
+PriorityLrfuPolicy::renormalize(int shift)
 {
-  BOOST_ASSERT(!m_queues[heaplist].empty());
+  NFD_LOG_DEBUG("Renormalize CRF by 2^-" << shift);
+
+  // scaling every key by the same power of two is exact and preserves heap order
+  this->forEachEntryInfo([shift] (EntryInfo* entryInfo) {
+    entryInfo->crf = std::ldexp(entryInfo->crf, -shift);
+    entryInfo->inflation = std::ldexp(entryInfo->inflation, -shift);
+  });
+  m_inflation = std::ldexp(m_inflation, -shift);
+  m_epoch += shift / m_lambda;
+  m_weightTime = m_epoch;
+  m_weight = 1.0;
+}
 
-  iterator lowestCrfPointer;
-  double tempCrf = 9999.0;
-  double getCrf;
-  int list = 1;
+double
+PriorityLrfuPolicy::getCrf(const EntryInfo* entryInfo, double currentTime) const
+{
+  return entryInfo->crf * std::exp2(-m_lambda * (currentTime - m_epoch));
+}
 
-  for(auto it = m_queues[heaplist].begin(); it != m_queues[heaplist].end(); ++it)
-  {
-      if(m_entryInfoMap[*it]->queueType == heaplist){
-        NFD_LOG_INFO( list << ". HeapList CRF Value: " << m_entryInfoMap[*it]->crf);
+void
+PriorityLrfuPolicy::referenceEntry(iterator i)
+{
+  BOOST_ASSERT(i->getPolicyInfo() != nullptr);
 
-        getCrf = m_entryInfoMap[*it]->crf;
-          if ( tempCrf > getCrf)
-          {
-            tempCrf = getCrf;
-            lowestCrfPointer = *it;
-          }
-          else if (tempCrf == getCrf){
-          	//do nothing
-          }
-      }
-      list ++;
-  }
-  NFD_LOG_INFO("-- Lowest CRF: " << tempCrf);
-  NFD_LOG_INFO("-- Lowest Iterator: " << m_entryInfoMap[lowestCrfPointer]);
+  EntryInfo* entryInfo = getEntryInfo<EntryInfo>(i);
+  this->updateCRF(i);
+  LRFU_TRACE(REFERENCE, i, entryInfo);
 
-  if (status == true){
-    this->moveToLinkedList(lowestCrfPointer);
+  // an unsolicited or stale entry stays in its list
+  if (entryInfo->queueType == linkedlist) {
+    if (this->isHeapFull()) {
+      this->demoteHeapTop();
+    }
+    this->moveToHeapList(i);
+  }
+  else if (entryInfo->queueType == heaplist) {
+    m_heap.update(entryInfo);
   }
+}
+
+void
+PriorityLrfuPolicy::demoteHeapTop()
+{
+  BOOST_ASSERT(!m_heap.empty());
+
+  EntryInfo* entryInfo = m_heap.top();
+  m_heap.erase(entryInfo);
 
+  entryInfo->queueType = linkedlist;
+  m_linkedList.push_back(getQueueEntry(entryInfo->entryIt));
+
+  LRFU_TRACE(DEMOTE, entryInfo->entryIt, entryInfo);
 }
 
 void
-PriorityLrfuPolicy::moveToLinkedList(iterator i)
+PriorityLrfuPolicy::moveToHeapList(iterator i)
 {
-    EntryInfo* entryInfo = m_entryInfoMap[i];
-    m_queues[heaplist].erase(entryInfo->queueIt);
+  EntryInfo* entryInfo = getEntryInfo<EntryInfo>(i);
+  BOOST_ASSERT(entryInfo->queueType == linkedlist);
+  m_linkedList.erase(m_linkedList.iterator_to(*i));
 
-    entryInfo->queueType = linkedlist;
-    Queue&queue = m_queues[linkedlist];
-    entryInfo->queueIt = queue.insert(queue.end(),i);
-    m_entryInfoMap[i] = entryInfo;
+  entryInfo->queueType = heaplist;
+  m_heap.push(entryInfo);
+
+  LRFU_TRACE(PROMOTE, i, entryInfo);
+}
 
-    if(m_entryInfoMap[i]->queueType==linkedlist){
-      NFD_LOG_INFO("Move to LinkedList (1) ; Crf = " << m_entryInfoMap[i]->crf);
+void
+PriorityLrfuPolicy::insertToHeap(EntryInfo* entryInfo)
+{
+  if (this->isHeapFull()) {
+    this->demoteHeapTop();
   }
+  entryInfo->queueType = heaplist;
+  m_heap.push(entryInfo);
 }
 
 void
-PriorityLrfuPolicy::moveToHeapList(iterator i)
+PriorityLrfuPolicy::moveToStaleList(iterator i)
 {
-    EntryInfo* entryInfo = m_entryInfoMap[i];
-    m_queues[linkedlist].erase(entryInfo->queueIt);
+  BOOST_ASSERT(i->getPolicyInfo() != nullptr);
 
-    entryInfo->queueType = heaplist;
-    Queue&queue = m_queues[heaplist];
-    entryInfo->queueIt = queue.insert(queue.end(),i);
-    m_entryInfoMap[i] = entryInfo;
+  EntryInfo* entryInfo = getEntryInfo<EntryInfo>(i);
+  if (entryInfo->queueType == heaplist) {
+    m_heap.erase(entryInfo);
+  }
+  else {
+    BOOST_ASSERT(entryInfo->queueType == linkedlist);
+    m_linkedList.erase(m_linkedList.iterator_to(*i));
+  }
 
-    NFD_LOG_INFO("Move To HeapList (0) ; CRF = " <<m_entryInfoMap[i]->crf);
+  entryInfo->queueType = stale;
+  m_staleList.push_back(getQueueEntry(i));
 
+  LRFU_TRACE(STALE, i, entryInfo);
 }
 
 } // namespace lrfu
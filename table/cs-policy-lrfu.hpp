@@ -27,17 +27,30 @@
 #define NFD_DAEMON_TABLE_CS_POLICY_LRFU_HPP
 
 #include "cs-policy.hpp"
+#include "object-pool.hpp"
 #include "core/scheduler.hpp"
 
+/** \brief when nonzero, PriorityLrfuPolicy reports its decisions as trace events
+ *
+ *  Tracing defaults to enabled in debug builds and disabled when NDEBUG is defined.
+ *  When disabled, trace events are not constructed and their CRF values are not computed.
+ *  This must be defined consistently across the build, because it changes the class layout.
+ */
+#ifndef NFD_CS_LRFU_TRACE
+#ifdef NDEBUG
+#define NFD_CS_LRFU_TRACE 0
+#else
+#define NFD_CS_LRFU_TRACE 1
+#endif
+#endif // NFD_CS_LRFU_TRACE
 
 namespace nfd {
 namespace cs {
 namespace lrfu {
 
-typedef std::list<iterator> Queue;
-typedef Queue::iterator QueueIt;
-
 enum QueueType{
+  unsolicited,
+  stale,
   heaplist,
   linkedlist,
   lrfu
@@ -46,24 +59,130 @@ enum QueueType{
 struct EntryInfo
 {
   QueueType queueType;
-  double crf;
+  double crf; ///< CRF scaled by 2^(lambda * (now - epoch)), comparable across entries at any time
+  double weight; ///< multiplies CRF in the replacement order, 1 unless the policy is cost-aware
+  double inflation; ///< GreedyDual aging value L when the entry was last referenced, scaled like crf
   double lastReferencedTime;
-  QueueIt queueIt;
-  scheduler::EventId moveListEventId;
+  iterator entryIt; ///< the entry, needed to move it from the heap to the linked list
+  size_t heapIndex; ///< position in heap, valid if queueType == heaplist
+  scheduler::EventId moveListEventId; ///< moves the entry to the stale list, valid if in heap or linked list
+
+  /** \return key of the entry in the heap; the entry with the lowest priority is evicted first
+   */
+  double
+  getPriority() const
+  {
+    return inflation + crf * weight;
+  }
+};
+
+typedef EntryQueue Queue;
+
+std::ostream&
+operator<<(std::ostream& os, QueueType queueType);
+
+/** \brief kind of a decision made by PriorityLrfuPolicy
+ */
+enum class TraceEventType {
+  INSERT,    ///< a new entry is attached to a queue
+  REFERENCE, ///< an entry is found by a lookup or refreshed, and its CRF is updated
+  PROMOTE,   ///< an entry moves from the linked list to the heap
+  DEMOTE,    ///< the heap entry with the lowest priority moves to the linked list
+  STALE,     ///< an entry moves to the stale list when its Data becomes stale
+  EVICT      ///< an entry is selected as victim
 };
 
-struct EntryItComparator
+std::ostream&
+operator<<(std::ostream& os, TraceEventType type);
+
+/** \brief a decision made by PriorityLrfuPolicy
+ */
+struct TraceEvent
 {
+  TraceEventType type;
+  iterator entry;
+  QueueType queueType; ///< queue of the entry after the event, or before it for EVICT
+  double crf;          ///< actual (decayed) CRF of the entry at the time of the event
+};
 
+/** \brief an indexed binary min-heap of entries keyed on weighted CRF
+ *
+ *  Every EntryInfo in the heap stores its own position in EntryInfo::heapIndex,
+ *  so that an entry can be located, re-keyed after a CRF change, or removed in O(log n)
+ *  without scanning the heap.
+ */
+class CrfHeap
+{
+public:
   bool
-  operator()(const iterator& a, const iterator& b) const
+  empty() const
   {
-    return *a < *b;
+    return m_heap.empty();
   }
 
-};
+  size_t
+  size() const
+  {
+    return m_heap.size();
+  }
+
+  std::vector<EntryInfo*>::const_iterator
+  begin() const
+  {
+    return m_heap.begin();
+  }
+
+  std::vector<EntryInfo*>::const_iterator
+  end() const
+  {
+    return m_heap.end();
+  }
 
-typedef std::map<iterator, EntryInfo*, EntryItComparator> EntryInfoMapLrfu;
+  /** \return the entry with the lowest priority
+   *  \pre !empty()
+   */
+  EntryInfo*
+  top() const
+  {
+    BOOST_ASSERT(!m_heap.empty());
+    return m_heap.front();
+  }
+
+  /** \brief inserts an entry
+   *  \post info->heapIndex is its position in the heap
+   */
+  void
+  push(EntryInfo* info);
+
+  /** \brief removes an entry
+   *  \pre the entry is in the heap
+   */
+  void
+  erase(EntryInfo* info);
+
+  /** \brief restores heap order after the priority of an entry has changed
+   *  \pre the entry is in the heap
+   */
+  void
+  update(EntryInfo* info);
+
+private:
+  void
+  place(size_t pos, EntryInfo* info)
+  {
+    m_heap[pos] = info;
+    info->heapIndex = pos;
+  }
+
+  void
+  siftUp(size_t pos);
+
+  void
+  siftDown(size_t pos);
+
+private:
+  std::vector<EntryInfo*> m_heap;
+};
 
 /** \brief Priority LRFU cs replacement policy
  *
@@ -72,6 +191,11 @@ typedef std::map<iterator, EntryInfo*, EntryItComparator> EntryInfoMapLrfu;
  * forwarding of the corresponding Interest packet.
  * Next, the Data packets with expired freshness are removed.
  * Last, the Data packets are removed from the Content Store on a pure LRFU basis.
+ *
+ * Data without a FreshnessPeriod (or with FreshnessPeriod 0) is stale as soon as it arrives.
+ * Such Data never moves to the stale list, and is ordered by LRFU like fresh Data: otherwise,
+ * with producers that do not set a FreshnessPeriod (the default of ndnSIM Producer), every entry
+ * would land in the FIFO stale list and the policy would degrade to FIFO.
  */
 class PriorityLrfuPolicy : public Policy
 {
@@ -81,13 +205,107 @@ public:
   virtual
   ~PriorityLrfuPolicy();
 
+protected:
+  /** \brief constructs a policy derived from LRFU
+   *  \param isCostAware whether victims are chosen by weighted priority among all solicited
+   *                     fresh entries, with GreedyDual aging; see getEntryWeight
+   */
+  PriorityLrfuPolicy(const std::string& policyName, bool isCostAware);
+
 public:
   static const std::string POLICY_NAME;
 
+  /** \brief default decay rate, giving F(x) = (1/2)^(0.1 * x) with x in seconds
+   */
+  static const double DEFAULT_LAMBDA;
+
+  /** \brief default maximum number of entries in the heap
+   */
+  static const size_t DEFAULT_HEAP_SIZE;
+
+public:
+  /** \brief gets decay rate lambda of the weighing function F(x) = (1/2)^(lambda * x)
+   */
+  double
+  getLambda() const
+  {
+    return m_lambda;
+  }
+
+  /** \brief sets decay rate lambda
+   *  \pre lambda >= 0
+   *
+   *  lambda = 0 gives LFU; larger values move the policy towards LRU.
+   *  CRF values of existing entries are preserved.
+   */
+  void
+  setLambda(double lambda);
+
+  /** \brief gets maximum number of entries in the heap
+   */
+  size_t
+  getHeapSize() const
+  {
+    return m_heapSize;
+  }
+
+  /** \brief sets maximum number of entries in the heap
+   *  \pre heapSize > 0
+   *
+   *  If the heap holds more entries, those with the lowest priority are moved to the linked list.
+   *  A cost-aware policy keeps every solicited fresh entry in the heap, and ignores this limit.
+   */
+  void
+  setHeapSize(size_t heapSize);
+
+  virtual QueueOccupancy
+  getQueueOccupancy() const override;
+
+  virtual iterator
+  peekVictim() const override;
+
+  /** \return the actual (decayed) CRF of the entry
+   */
+  virtual double
+  getEntryScore(iterator i) const override;
+
+#if NFD_CS_LRFU_TRACE
+public:
+  /** \brief signals every decision of the policy
+   *
+   *  This signal exists only when NFD_CS_LRFU_TRACE is nonzero.
+   *  Each event is also logged at TRACE level.
+   */
+  signal::Signal<PriorityLrfuPolicy, TraceEvent> afterTraceEvent;
+
+protected:
+  DECLARE_SIGNAL_EMIT(afterTraceEvent)
+
+private:
+  void
+  trace(TraceEventType type, iterator i, const EntryInfo* entryInfo);
+#endif // NFD_CS_LRFU_TRACE
+
+protected:
+  /** \return weight of a newly inserted entry, which multiplies its CRF in the heap order
+   *
+   *  The default weight is 1, which gives pure LRFU ordering.
+   *  A cost-aware subclass overrides this. Its heap then holds every solicited fresh entry,
+   *  so that the victim after the unsolicited and stale lists is the entry with the lowest
+   *  L + CRF * weight, where L is raised to the priority of each such victim when it is evicted.
+   *  This is the aging of GreedyDual-Size: entries that are not referenced again are eventually
+   *  overtaken by the inflation value, however high their weight.
+   */
+  virtual double
+  getEntryWeight(iterator i) const;
+
 private:
   virtual void
   doAfterInsert(iterator i) override;
 
+  virtual void
+  doAfterLoad(iterator i, double score) override;
+
   virtual void
   doAfterRefresh(iterator i) override;
 
@@ -97,15 +315,10 @@ private:
   virtual void
   doBeforeUse(iterator i) override;
 
-  virtual void
-  evictEntries() override;
+  virtual iterator
+  selectVictim() override;
 
 private:
-  /** \brief evicts one entry
-   *  \pre CS is not empty
-   */
-  void
-  evictOne();
 
   /** \brief attaches the entry to an appropriate queue
    *  \pre the entry is not in any queue
@@ -113,31 +326,125 @@ private:
   void
   attachQueue(iterator i);
 
+  /** \brief creates the EntryInfo of an entry referenced once at \p referencedTime
+   *  \pre the entry has no EntryInfo
+   *  \return the EntryInfo, attached to the entry but not to any queue
+   */
+  EntryInfo*
+  createEntryInfo(iterator i, double referencedTime);
+
+  /** \brief schedules moving the entry to the stale list when its Data becomes stale
+   */
+  void
+  scheduleMoveToStaleList(iterator i, EntryInfo* entryInfo);
+
   /** \brief detaches the entry from its current queue
    *  \post the entry is not in any queue
    */
   void
   detachQueue(iterator i);
 
-  /** \brief moves an entry from LRFU queue to STALE queue
+  /** \brief appends the entry to the unsolicited or stale list, if it belongs to either
+   *  \return whether the entry has been attached
+   */
+  bool
+  attachPriorityQueue(iterator i, EntryInfo* entryInfo);
+
+  /** \brief updates the CRF of an entry that has just been referenced
    */
   void
   updateCRF(iterator i);
 
+  /** \return the scaled value of one reference made at \p currentTime
+   *
+   *  A reference at time t contributes F(now - t) = 2^(-lambda * (now - t)) to CRF.
+   *  Storing every CRF multiplied by 2^(lambda * (now - epoch)) makes this contribution
+   *  2^(lambda * (t - epoch)), which does not depend on now; therefore stored values need not be
+   *  decayed over time and remain directly comparable.
+   *  The weight is computed at most once per distinct timestamp.
+   */
+  double
+  getReferenceWeight(double currentTime);
+
+  /** \brief moves the epoch forward, dividing all scaled CRF values by 2^shift
+   */
   void
-  restoreHeapStructure(bool status);
+  renormalize(int shift);
 
+  /** \return the actual (decayed) CRF of an entry at \p currentTime
+   */
+  double
+  getCrf(const EntryInfo* entryInfo, double currentTime) const;
+
+  /** \brief invokes \p f for the EntryInfo of every entry in the policy
+   */
+  template<typename F>
   void
-  moveToLinkedList(iterator i);
+  forEachEntryInfo(const F& f)
+  {
+    for (EntryInfo* entryInfo : m_heap) {
+      f(entryInfo);
+    }
+    for (const Queue* queue : {&m_unsolicitedList, &m_staleList, &m_linkedList}) {
+      for (const EntryImpl& entry : *queue) {
+        f(static_cast<EntryInfo*>(entry.getPolicyInfo()));
+      }
+    }
+  }
+
+  /** \brief handles a reference to an entry found in the CS
+   *
+   *  The CRF of the entry is updated. An entry in the linked list is promoted to the heap,
+   *  demoting the heap entry with the lowest priority if the heap is full.
+   *  An unsolicited or stale entry stays in its list.
+   */
+  void
+  referenceEntry(iterator i);
+
+  /** \return whether an entry entering the heap must demote the heap top
+   */
+  bool
+  isHeapFull() const
+  {
+    return !m_isCostAware && m_heap.size() >= m_heapSize;
+  }
+
+  /** \brief moves the heap entry with the lowest priority to the tail of the linked list
+   *  \pre heap is not empty
+   */
+  void
+  demoteHeapTop();
 
   void
   moveToHeapList(iterator i);
 
+  /** \brief inserts an entry into the heap, demoting the heap top if the heap is full
+   */
+  void
+  insertToHeap(EntryInfo* entryInfo);
+
+  /** \brief moves an entry whose Data has become stale from the heap or linked list
+   *         to the stale list
+   */
+  void
+  moveToStaleList(iterator i);
+
 
 private:
-  // Queue m_queues[QUEUE_MAX];
-  Queue m_queues[lrfu];
-  EntryInfoMapLrfu m_entryInfoMap;
+  ObjectPool<EntryInfo> m_entryInfoPool;
+  Queue m_unsolicitedList;
+  Queue m_staleList;
+  CrfHeap m_heap;
+  Queue m_linkedList;
+
+  const bool m_isCostAware;
+  double m_lambda;
+  size_t m_heapSize;
+  double m_inflation; ///< GreedyDual aging value L, scaled like crf; stays 0 unless cost-aware
+  double m_epoch; ///< reference time of scaled CRF values, in seconds
+  double m_weightTime; ///< time of the last computed reference weight
+  double m_weight; ///< reference weight at m_weightTime
+
 };
 
 } // namespace priority_lrfu
@@ -38,22 +38,37 @@ LruPolicy::LruPolicy()
 {
 }
 
+LruPolicy::~LruPolicy()
+{
+  m_queue.clear();
+}
+
+Policy::QueueOccupancy
+LruPolicy::getQueueOccupancy() const
+{
+  return {{"lru", m_queue.size()}};
+}
+
 void
 LruPolicy::doBeforeErase(iterator i)
 {
-  m_queue.get<1>().erase(i);
+  m_queue.erase(m_queue.iterator_to(*i));
 }
 
-void
-LruPolicy::evictEntries()                             //Mengeluarkan / Menghapus Interest terlama
+iterator
+LruPolicy::peekVictim() const
 {
-  BOOST_ASSERT(this->getCs() != nullptr);             //cek apakah CS pointer tidak kosong
-  while (this->getCs()->size() > this->getLimit()) {  //saat ukuran CS melebihi (>) limit
-    BOOST_ASSERT(!m_queue.empty());                   //Cek apakah m_queue tidak kosong, kalo isi lanjut
-    iterator i = m_queue.front();                     //Menunjuk yang paling depan dan dimasukkan ke iterator i
-    m_queue.pop_front();                              //menghapus interest paling depan (begin) / paling baru
-    this->emitSignal(beforeEvict, i);                 //Menghapus data "it" di Tabel
-  }
+  BOOST_ASSERT(!m_queue.empty());
+  return m_queue.front().getIterator();
+}
+
+iterator
+LruPolicy::selectVictim()                             //Memilih Interest terlama untuk dihapus
+{
+  BOOST_ASSERT(!m_queue.empty());                     //Cek apakah m_queue tidak kosong, kalo isi lanjut
+  iterator i = m_queue.front().getIterator();         //Menunjuk yang paling depan dan dimasukkan ke iterator i
+  m_queue.pop_front();                                //menghapus interest paling depan (begin) / paling baru
+  return i;                                           //Data "i" dihapus dari Tabel oleh CS
 }
 
 void
@@ -77,19 +92,14 @@ LruPolicy::doAfterRefresh(iterator i)
 void
 LruPolicy::insertToQueue(iterator i, bool isNewEntry)
 {
-  Queue::iterator it;
-  bool isNew = false;                                 //Deklarasi isNew = False
-  // push_back only if iterator i does not exist
-  std::tie(it, isNew) = m_queue.push_back(i);         // Menambahkan entry interest ke paling belakang
-
-  // NFD_LOG_INFO("PushBack Entries Success");
+  EntryImpl& entry = getQueueEntry(i);
+  BOOST_ASSERT(entry.is_linked() != isNewEntry);
 
   //untuk lookup interest // isNewEntry == FALSE
-  BOOST_ASSERT(isNew == isNewEntry);
   if (!isNewEntry) {
-    m_queue.relocate(m_queue.end(), it);            // Memindahkan entry pada "it" ke paling belakang
-    // NFD_LOG_INFO("Relocate Entries Success");
+    m_queue.erase(m_queue.iterator_to(entry));      // Memindahkan entry ke paling belakang
   }                                                 // Memindahkan yang direferensi saja.
+  m_queue.push_back(entry);                         // Menambahkan entry interest ke paling belakang
 }
 
 } // namespace lru
@@ -28,32 +28,11 @@
 
 #include "cs-policy.hpp"
 
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/sequenced_index.hpp>
-#include <boost/multi_index/hashed_index.hpp>
-
 namespace nfd {
 namespace cs {
 namespace lru {
 
-struct EntryItComparator
-{
-  bool
-  operator()(const iterator& a, const iterator& b) const
-  {
-    return *a < *b;
-  }
-};
-
-typedef boost::multi_index_container<
-    iterator,
-    boost::multi_index::indexed_by<
-      boost::multi_index::sequenced<>,
-      boost::multi_index::ordered_unique<
-        boost::multi_index::identity<iterator>, EntryItComparator
-      >
-    >
-  > Queue;
+typedef EntryQueue Queue;
 
 /** \brief LRU cs replacement policy
  *
@@ -66,9 +45,17 @@ class LruPolicy : public Policy
 public:
   LruPolicy();
 
+  ~LruPolicy();
+
 public:
   static const std::string POLICY_NAME;
 
+  virtual QueueOccupancy
+  getQueueOccupancy() const override;
+
+  virtual iterator
+  peekVictim() const override;
+
 private:
   virtual void
   doAfterInsert(iterator i) override;
@@ -82,8 +69,8 @@ private:
   virtual void
   doBeforeUse(iterator i) override;
 
-  virtual void
-  evictEntries() override;
+  virtual iterator
+  selectVictim() override;
 
 private:
   /** \brief moves an entry to the end of queue
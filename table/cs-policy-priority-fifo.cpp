@@ -40,11 +40,26 @@ PriorityFifoPolicy::PriorityFifoPolicy()
 
 PriorityFifoPolicy::~PriorityFifoPolicy()
 {
-  for (auto entryInfoMapPair : m_entryInfoMap) {
-    delete entryInfoMapPair.second;
+  for (Queue& queue : m_queues) {
+    queue.clear_and_dispose([this] (EntryImpl* entry) {
+      EntryInfo* entryInfo = static_cast<EntryInfo*>(entry->getPolicyInfo());
+      if (entryInfo->queueType == QUEUE_FIFO) {
+        scheduler::cancel(entryInfo->moveStaleEventId);
+      }
+      entry->setPolicyInfo(nullptr);
+      m_entryInfoPool.destroy(entryInfo);
+    });
   }
 }
 
+Policy::QueueOccupancy
+PriorityFifoPolicy::getQueueOccupancy() const
+{
+  return {{"unsolicited", m_queues[QUEUE_UNSOLICITED].size()},
+          {"stale", m_queues[QUEUE_STALE].size()},
+          {"fifo", m_queues[QUEUE_FIFO].size()}};
+}
+
 void
 PriorityFifoPolicy::doAfterInsert(iterator i)
 {
@@ -68,47 +83,39 @@ PriorityFifoPolicy::doBeforeErase(iterator i)
 void
 PriorityFifoPolicy::doBeforeUse(iterator i)
 {
-  BOOST_ASSERT(m_entryInfoMap.find(i) != m_entryInfoMap.end());
+  BOOST_ASSERT(i->getPolicyInfo() != nullptr);
 }
 
-void
-PriorityFifoPolicy::evictEntries()
-{
-  BOOST_ASSERT(this->getCs() != nullptr);
-
-  while (this->getCs()->size() > this->getLimit()) {
-    this->evictOne();
-  }
-}
-
-void
-PriorityFifoPolicy::evictOne()
+iterator
+PriorityFifoPolicy::peekVictim() const
 {
   BOOST_ASSERT(!m_queues[QUEUE_UNSOLICITED].empty() ||
                !m_queues[QUEUE_STALE].empty() ||
                !m_queues[QUEUE_FIFO].empty());
 
-  iterator i;
   if (!m_queues[QUEUE_UNSOLICITED].empty()) {
-    i = m_queues[QUEUE_UNSOLICITED].front();
+    return m_queues[QUEUE_UNSOLICITED].front().getIterator();
   }
-  else if (!m_queues[QUEUE_STALE].empty()) {
-    i = m_queues[QUEUE_STALE].front();
-  }
-  else if (!m_queues[QUEUE_FIFO].empty()) {
-    i = m_queues[QUEUE_FIFO].front();
+  if (!m_queues[QUEUE_STALE].empty()) {
+    return m_queues[QUEUE_STALE].front().getIterator();
   }
+  return m_queues[QUEUE_FIFO].front().getIterator();
+}
 
+iterator
+PriorityFifoPolicy::selectVictim()
+{
+  iterator i = this->peekVictim();
   this->detachQueue(i);
-  this->emitSignal(beforeEvict, i);
+  return i;
 }
 
 void
 PriorityFifoPolicy::attachQueue(iterator i)
 {
-  BOOST_ASSERT(m_entryInfoMap.find(i) == m_entryInfoMap.end());
+  BOOST_ASSERT(i->getPolicyInfo() == nullptr);
 
-  EntryInfo* entryInfo = new EntryInfo();
+  EntryInfo* entryInfo = m_entryInfoPool.construct();
   if (i->isUnsolicited()) {
     entryInfo->queueType = QUEUE_UNSOLICITED;
   }
@@ -117,44 +124,43 @@ PriorityFifoPolicy::attachQueue(iterator i)
   }
   else {
     entryInfo->queueType = QUEUE_FIFO;
-    entryInfo->moveStaleEventId = scheduler::schedule(i->getData().getFreshnessPeriod(),
+    // an entry loaded from a previous policy may have part of its freshness period left
+    entryInfo->moveStaleEventId = scheduler::schedule(i->getStaleTime() - time::steady_clock::now(),
                                                       [=] { moveToStaleQueue(i); });
   }
 
-  Queue& queue = m_queues[entryInfo->queueType];
-  entryInfo->queueIt = queue.insert(queue.end(), i);
-  m_entryInfoMap[i] = entryInfo;
+  m_queues[entryInfo->queueType].push_back(getQueueEntry(i));
+  i->setPolicyInfo(entryInfo);
 }
 
 void
 PriorityFifoPolicy::detachQueue(iterator i)
 {
-  BOOST_ASSERT(m_entryInfoMap.find(i) != m_entryInfoMap.end());
+  BOOST_ASSERT(i->getPolicyInfo() != nullptr);
 
-  EntryInfo* entryInfo = m_entryInfoMap[i];
+  EntryInfo* entryInfo = getEntryInfo<EntryInfo>(i);
   if (entryInfo->queueType == QUEUE_FIFO) {
     scheduler::cancel(entryInfo->moveStaleEventId);
   }
 
-  m_queues[entryInfo->queueType].erase(entryInfo->queueIt);
-  m_entryInfoMap.erase(i);
-  delete entryInfo;
+  Queue& queue = m_queues[entryInfo->queueType];
+  queue.erase(queue.iterator_to(*i));
+  i->setPolicyInfo(nullptr);
+  m_entryInfoPool.destroy(entryInfo);
 }
 
 void
 PriorityFifoPolicy::moveToStaleQueue(iterator i)
 {
-  BOOST_ASSERT(m_entryInfoMap.find(i) != m_entryInfoMap.end());
+  BOOST_ASSERT(i->getPolicyInfo() != nullptr);
 
-  EntryInfo* entryInfo = m_entryInfoMap[i];
+  EntryInfo* entryInfo = getEntryInfo<EntryInfo>(i);
   BOOST_ASSERT(entryInfo->queueType == QUEUE_FIFO);
 
-  m_queues[QUEUE_FIFO].erase(entryInfo->queueIt);
+  m_queues[QUEUE_FIFO].erase(m_queues[QUEUE_FIFO].iterator_to(*i));
 
   entryInfo->queueType = QUEUE_STALE;
-  Queue& queue = m_queues[QUEUE_STALE];
-  entryInfo->queueIt = queue.insert(queue.end(), i);
-  m_entryInfoMap[i] = entryInfo;
+  m_queues[QUEUE_STALE].push_back(getQueueEntry(i));
 }
 
 } // namespace priority_fifo
@@ -27,17 +27,13 @@
 #define NFD_DAEMON_TABLE_CS_POLICY_PRIORITY_FIFO_HPP
 
 #include "cs-policy.hpp"
+#include "object-pool.hpp"
 #include "core/scheduler.hpp"
 
-#include <list>
-
 namespace nfd {
 namespace cs {
 namespace priority_fifo {
 
-typedef std::list<iterator> Queue;
-typedef Queue::iterator QueueIt;
-
 enum QueueType {
   QUEUE_UNSOLICITED,
   QUEUE_STALE,
@@ -48,20 +44,10 @@ enum QueueType {
 struct EntryInfo
 {
   QueueType queueType;
-  QueueIt queueIt;
   scheduler::EventId moveStaleEventId;
 };
 
-struct EntryItComparator
-{
-  bool
-  operator()(const iterator& a, const iterator& b) const
-  {
-    return *a < *b;
-  }
-};
-
-typedef std::map<iterator, EntryInfo*, EntryItComparator> EntryInfoMapFifo;
+typedef EntryQueue Queue;
 
 /** \brief Priority FIFO replacement policy
  *
@@ -86,6 +72,12 @@ public:
 public:
   static const std::string POLICY_NAME;
 
+  virtual QueueOccupancy
+  getQueueOccupancy() const override;
+
+  virtual iterator
+  peekVictim() const override;
+
 private:
   void
   doAfterInsert(iterator i) override;
@@ -99,15 +91,10 @@ private:
   void
   doBeforeUse(iterator i) override;
 
-  void
-  evictEntries() override;
+  iterator
+  selectVictim() override;
 
 private:
-  /** \brief evicts one entry
-   *  \pre CS is not empty
-   */
-  void
-  evictOne();
 
   /** \brief attaches the entry to an appropriate queue
    *  \pre the entry is not in any queue
@@ -127,8 +114,8 @@ private:
   moveToStaleQueue(iterator i);
 
 private:
+  ObjectPool<EntryInfo> m_entryInfoPool;
   Queue m_queues[QUEUE_MAX];
-  EntryInfoMapFifo m_entryInfoMap;
 };
 
 } // namespace priority_fifo
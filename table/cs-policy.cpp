@@ -60,6 +60,8 @@ Policy::getPolicyNames()
 
 Policy::Policy(const std::string& policyName)
   : m_policyName(policyName)
+  , m_byteLimit(std::numeric_limits<size_t>::max())
+  , m_lowWatermark(std::numeric_limits<size_t>::max())
 {
 }
 
@@ -71,6 +73,58 @@ Policy::setLimit(size_t nMaxEntries)
   this->evictEntries();
 }
 
+void
+Policy::setByteLimit(size_t nMaxBytes)
+{
+  NFD_LOG_INFO("setByteLimit " << nMaxBytes);
+  m_byteLimit = nMaxBytes;
+  this->evictEntries();
+}
+
+void
+Policy::setLowWatermark(size_t nEntries)
+{
+  NFD_LOG_INFO("setLowWatermark " << nEntries);
+  m_lowWatermark = nEntries;
+}
+
+Policy::QueueOccupancy
+Policy::getQueueOccupancy() const
+{
+  return {};
+}
+
+void
+Policy::evictEntries()
+{
+  BOOST_ASSERT(m_cs != nullptr);
+
+  if (!this->needsEviction()) {
+    return;
+  }
+
+  size_t nEntries = m_cs->size();
+  size_t nBytes = m_cs->byteSize();
+  size_t target = nEntries > m_limit ? this->getLowWatermark() : m_limit;
+  BOOST_ASSERT(m_victims.empty());
+  while (nEntries - m_victims.size() > target || nBytes > m_byteLimit) {
+    iterator victim = this->selectVictim();
+    nBytes -= victim->getWireSize();
+    m_victims.push_back(victim);
+  }
+
+  NFD_LOG_DEBUG("evict " << m_victims.size() << " entries, " << nBytes << " octets remaining");
+  this->emitSignal(beforeEvictBatch, m_victims);
+  m_victims.clear();
+}
+
+bool
+Policy::needsEviction() const
+{
+  BOOST_ASSERT(m_cs != nullptr);
+  return m_cs->size() > m_limit || m_cs->byteSize() > m_byteLimit;
+}
+
 void
 Policy::afterInsert(iterator i)
 {
@@ -79,6 +133,30 @@ Policy::afterInsert(iterator i)
   this->doAfterInsert(i);
 }
 
+double
+Policy::getEntryScore(iterator i) const
+{
+  return 0.0;
+}
+
+void
+Policy::afterLoad(const std::vector<LoadedEntry>& entries)
+{
+  NFD_LOG_INFO("After Load " << entries.size());
+
+  BOOST_ASSERT(m_cs != nullptr);
+  for (const LoadedEntry& entry : entries) {
+    this->doAfterLoad(entry.it, entry.score);
+  }
+  this->evictEntries();
+}
+
+void
+Policy::doAfterLoad(iterator i, double score)
+{
+  this->doAfterInsert(i);
+}
+
 void
 Policy::afterRefresh(iterator i)
 {
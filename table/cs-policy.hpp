@@ -94,6 +94,69 @@ public:
   void
   setLimit(size_t nMaxEntries);
 
+  /** \brief gets byte limit (in octets of Data wire encoding)
+   */
+  size_t
+  getByteLimit() const;
+
+  /** \brief sets byte limit (in octets of Data wire encoding)
+   *  \post getByteLimit() == nMaxBytes
+   *  \post cs.byteSize() <= getByteLimit()
+   *
+   *  The byte limit applies in addition to the hard limit in number of entries.
+   *  By default, there is no byte limit.
+   *  The policy may evict entries if necessary.
+   */
+  void
+  setByteLimit(size_t nMaxBytes);
+
+  /** \brief gets low watermark (in number of entries)
+   *
+   *  When CS size exceeds the hard limit, the policy evicts entries until CS size does not
+   *  exceed the low watermark. The low watermark never exceeds the hard limit.
+   */
+  size_t
+  getLowWatermark() const;
+
+  /** \brief gets low watermark as set by setLowWatermark(), not limited by the hard limit
+   *
+   *  This is SIZE_MAX if the low watermark has not been set, i.e. it follows the hard limit.
+   *  Unlike getLowWatermark(), this value can be carried to another policy whose hard limit
+   *  is set later.
+   */
+  size_t
+  getConfiguredLowWatermark() const;
+
+  /** \brief sets low watermark (in number of entries)
+   *  \post getLowWatermark() == min(nEntries, getLimit())
+   *
+   *  A low watermark below the hard limit lets the policy evict a batch of entries at once,
+   *  instead of one entry after every insertion once CS is full.
+   *  By default, the low watermark follows the hard limit.
+   */
+  void
+  setLowWatermark(size_t nEntries);
+
+  /** \brief number of entries in each cleanup queue, indexed by queue name
+   */
+  typedef std::map<std::string, size_t> QueueOccupancy;
+
+  /** \return number of entries in each cleanup queue of the policy
+   *
+   *  The default implementation reports no queue.
+   */
+  virtual QueueOccupancy
+  getQueueOccupancy() const;
+
+  /** \return the entry that would be evicted next, without evicting it
+   *  \pre CS is not empty
+   *
+   *  This lets CS compare a new Data packet against the entry it would displace,
+   *  e.g. in an admission filter, before inserting the Data.
+   */
+  virtual iterator
+  peekVictim() const = 0;
+
   /** \brief emits when an entry is being evicted
    *
    *  A policy implementation should emit this signal to cause CS to erase the entry from its index.
@@ -101,6 +164,13 @@ public:
    */
   signal::Signal<Policy, iterator> beforeEvict;
 
+  /** \brief emits when a batch of entries is being evicted
+   *
+   *  CS should connect to this signal and erase all entries in the batch upon signal emission.
+   *  The entries have already been removed from the cleanup index of the policy.
+   */
+  signal::Signal<Policy, std::vector<iterator>> beforeEvictBatch;
+
   /** \brief invoked by CS after a new entry is inserted
    *  \post cs.size() <= getLimit()
    *
@@ -110,6 +180,32 @@ public:
   void
   afterInsert(iterator i);
 
+  /** \return a score of the entry from which this policy can restore its state,
+   *          or 0 if the policy keeps no score
+   *
+   *  The score is passed to doAfterLoad() when the entry is loaded into another policy,
+   *  or restored from a CS snapshot.
+   */
+  virtual double
+  getEntryScore(iterator i) const;
+
+  /** \brief an entry loaded into the policy
+   */
+  struct LoadedEntry
+  {
+    iterator it;
+    double score; ///< getEntryScore() under the previous policy, or 0 if unknown
+  };
+
+  /** \brief invoked by CS after entries that are not attached to any policy are added to CS
+   *  \param entries the entries, ordered from the least to the most recently inserted or refreshed
+   *  \post cs.size() <= getLimit()
+   *
+   *  This lets a CS change its policy without losing its content, or restore a snapshot.
+   */
+  void
+  afterLoad(const std::vector<LoadedEntry>& entries);
+
   /** \brief invoked by CS after an existing entry is refreshed by same Data
    *
    *  The policy may witness this refresh to make better eviction decisions in the future.
@@ -142,6 +238,16 @@ protected:
   virtual void
   doAfterInsert(iterator i) = 0;
 
+  /** \brief invoked for each entry loaded by afterLoad()
+   *  \param score score of the entry under its previous policy, or 0 if unknown
+   *
+   *  Entries are passed from the least to the most recently inserted or refreshed.
+   *  The default implementation treats each entry as newly inserted.
+   *  A policy may override this to give loaded entries better initial scores.
+   */
+  virtual void
+  doAfterLoad(iterator i, double score);
+
   /** \brief invoked after an existing entry is refreshed by same Data
    *
    *  When overridden in a subclass, a policy implementation may witness this operation
@@ -167,14 +273,55 @@ protected:
   virtual void
   doBeforeUse(iterator i) = 0;
 
-  /** \brief evicts zero or more entries
-   *  \post CS size does not exceed hard limit
+  /** \brief selects an entry to be evicted, and erases it from the cleanup index
+   *  \pre the cleanup index is not empty
+   *
+   *  When overridden in a subclass, a policy implementation should return the entry that is
+   *  evicted first according to its replacement order. CS erases the entry later, together with
+   *  other entries of the same batch, so \p beforeEvict signal should not be emitted.
    */
-  virtual void
-  evictEntries() = 0;
+  virtual iterator
+  selectVictim() = 0;
+
+  /** \brief evicts entries if CS size exceeds hard limit or byte limit
+   *  \post CS size does not exceed low watermark, if it exceeded hard limit
+   *  \post CS byte size does not exceed byte limit
+   *
+   *  Victims are selected with selectVictim(), and are passed to CS in a single
+   *  \p beforeEvictBatch signal.
+   */
+  void
+  evictEntries();
+
+  /** \return whether evictEntries() would evict, i.e. CS exceeds hard limit or byte limit
+   *
+   *  A policy may check this while attaching a new entry, to know whether the entry is about
+   *  to compete for eviction with entries already stored.
+   */
+  bool
+  needsEviction() const;
+
+  /** \return per-entry state attached to \p i by this policy, or nullptr if none
+   *  \tparam T type of per-entry state of the policy
+   */
+  template<typename T>
+  static T*
+  getEntryInfo(iterator i)
+  {
+    return static_cast<T*>(i->getPolicyInfo());
+  }
+
+  /** \return the entry referenced by \p i, for linking it into an EntryQueue
+   */
+  static EntryImpl&
+  getQueueEntry(iterator i)
+  {
+    return const_cast<EntryImpl&>(*i);
+  }
 
 protected:
   DECLARE_SIGNAL_EMIT(beforeEvict)
+  DECLARE_SIGNAL_EMIT(beforeEvictBatch)
 
 private: // registry
   typedef std::function<unique_ptr<Policy>()> CreateFunc;
@@ -186,7 +333,10 @@ private: // registry
 private:
   std::string m_policyName;
   size_t m_limit;
+  size_t m_byteLimit;
+  size_t m_lowWatermark;
   Cs* m_cs;
+  std::vector<iterator> m_victims; ///< reused buffer of evictEntries()
 };
 
 inline const std::string&
@@ -213,6 +363,24 @@ Policy::getLimit() const
   return m_limit;
 }
 
+inline size_t
+Policy::getByteLimit() const
+{
+  return m_byteLimit;
+}
+
+inline size_t
+Policy::getLowWatermark() const
+{
+  return std::min(m_lowWatermark, m_limit);
+}
+
+inline size_t
+Policy::getConfiguredLowWatermark() const
+{
+  return m_lowWatermark;
+}
+
 } // namespace cs
 } // namespace nfd
 
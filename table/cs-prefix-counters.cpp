@@ -0,0 +1,105 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2018,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cs-prefix-counters.hpp"
+#include "name-tree-hashtable.hpp"
+
+namespace nfd {
+namespace cs {
+
+void
+PrefixCounters::add(const Name& prefix)
+{
+  if (this->get(prefix) != nullptr) {
+    return;
+  }
+
+  m_records.emplace(std::piecewise_construct,
+                    std::forward_as_tuple(name_tree::computeHash(prefix)),
+                    std::forward_as_tuple(prefix));
+
+  auto pos = std::lower_bound(m_prefixLengths.begin(), m_prefixLengths.end(), prefix.size(),
+                              std::greater<size_t>());
+  if (pos == m_prefixLengths.end() || *pos != prefix.size()) {
+    m_prefixLengths.insert(pos, prefix.size());
+  }
+}
+
+const PrefixCounters::Counters*
+PrefixCounters::get(const Name& prefix) const
+{
+  auto range = m_records.equal_range(name_tree::computeHash(prefix));
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second.prefix == prefix) {
+      return &it->second.counters;
+    }
+  }
+  return nullptr;
+}
+
+void
+PrefixCounters::countHit(const Name& name)
+{
+  Counters* counters = this->findLongestPrefixMatch(name);
+  if (counters != nullptr) {
+    ++counters->nHits;
+  }
+}
+
+void
+PrefixCounters::countMiss(const Name& name)
+{
+  Counters* counters = this->findLongestPrefixMatch(name);
+  if (counters != nullptr) {
+    ++counters->nMisses;
+  }
+}
+
+PrefixCounters::Counters*
+PrefixCounters::findLongestPrefixMatch(const Name& name)
+{
+  if (m_records.empty()) {
+    return nullptr;
+  }
+
+  name_tree::HashSequence hashes = name_tree::computeHashes(name, m_prefixLengths.front());
+  for (size_t prefixLen : m_prefixLengths) {
+    if (prefixLen >= hashes.size()) {
+      continue;
+    }
+
+    auto range = m_records.equal_range(hashes[prefixLen]);
+    for (auto it = range.first; it != range.second; ++it) {
+      const Name& prefix = it->second.prefix;
+      if (prefix.size() == prefixLen && prefix.isPrefixOf(name)) {
+        return &it->second.counters;
+      }
+    }
+  }
+  return nullptr;
+}
+
+} // namespace cs
+} // namespace nfd
@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2018,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NFD_DAEMON_TABLE_CS_PREFIX_COUNTERS_HPP
+#define NFD_DAEMON_TABLE_CS_PREFIX_COUNTERS_HPP
+
+#include "core/common.hpp"
+#include "core/counter.hpp"
+
+#include <unordered_map>
+
+namespace nfd {
+namespace cs {
+
+/** \brief counts ContentStore hits and misses under configured Name prefixes
+ *
+ *  A lookup is attributed to the longest configured prefix of the Interest Name, if any.
+ *  Prefixes are located by their name_tree hash, so the cost of counting a lookup depends on
+ *  the number of distinct prefix lengths, not on the number of prefixes.
+ */
+class PrefixCounters : noncopyable
+{
+public:
+  struct Counters
+  {
+    PacketCounter nHits;
+    PacketCounter nMisses;
+  };
+
+  /** \brief starts counting lookups under \p prefix
+   *
+   *  Adding a prefix that is already counted has no effect.
+   */
+  void
+  add(const Name& prefix);
+
+  /** \return counters of \p prefix, or nullptr if \p prefix is not counted
+   */
+  const Counters*
+  get(const Name& prefix) const;
+
+  /** \return whether no prefix is counted
+   */
+  bool
+  empty() const
+  {
+    return m_records.empty();
+  }
+
+  /** \brief counts a lookup of \p name that found a match
+   */
+  void
+  countHit(const Name& name);
+
+  /** \brief counts a lookup of \p name that found no match
+   */
+  void
+  countMiss(const Name& name);
+
+private:
+  /** \return counters of the longest counted prefix of \p name, or nullptr if none
+   */
+  Counters*
+  findLongestPrefixMatch(const Name& name);
+
+private:
+  struct Record
+  {
+    explicit
+    Record(const Name& prefix)
+      : prefix(prefix)
+    {
+    }
+
+    Name prefix;
+    Counters counters;
+  };
+
+  std::unordered_multimap<size_t, Record> m_records; ///< indexed by name_tree hash of prefix
+  std::vector<size_t> m_prefixLengths; ///< distinct lengths of counted prefixes, longest first
+};
+
+} // namespace cs
+} // namespace nfd
+
+#endif // NFD_DAEMON_TABLE_CS_PREFIX_COUNTERS_HPP
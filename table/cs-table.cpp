@@ -0,0 +1,603 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2018,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cs-table.hpp"
+
+namespace nfd {
+namespace cs {
+
+static_assert(std::is_trivially_destructible<TableLeaf>::value &&
+              std::is_trivially_destructible<TableInner>::value,
+              "Table nodes are released with their pools without being destructed");
+
+const size_t TableNode::CAPACITY;
+const size_t TableNode::MIN_SIZE;
+
+/** \return TableKey of the first \p nComponents components of \p name
+ *
+ *  The key holds the TLV encoding of these components as if they were encoded in a Name,
+ *  which is built here from types and values so that the Name need not have a wire encoding.
+ */
+static TableKey
+makeKey(const Name& name, size_t nComponents)
+{
+  uint8_t octets[16] = {};
+  size_t length = 0;
+  auto append = [&] (uint8_t octet) {
+    if (length < sizeof(octets)) {
+      octets[length++] = octet;
+    }
+  };
+  auto appendVarNumber = [&] (uint64_t number) {
+    int nOctets = 1;
+    if (number < 253) {
+      append(static_cast<uint8_t>(number));
+      return;
+    }
+    else if (number <= 0xFFFF) {
+      append(253);
+      nOctets = 2;
+    }
+    else if (number <= 0xFFFFFFFF) {
+      append(254);
+      nOctets = 4;
+    }
+    else {
+      append(255);
+      nOctets = 8;
+    }
+    for (int shift = 8 * (nOctets - 1); shift >= 0; shift -= 8) {
+      append(static_cast<uint8_t>(number >> shift));
+    }
+  };
+
+  for (size_t i = 0; i < nComponents && length < sizeof(octets); ++i) {
+    const name::Component& component = name[i];
+    appendVarNumber(component.type());
+    appendVarNumber(component.value_size());
+    const uint8_t* value = component.value();
+    for (size_t j = 0; j < component.value_size() && length < sizeof(octets); ++j) {
+      append(value[j]);
+    }
+  }
+
+  TableKey key{0, 0};
+  for (size_t i = 0; i < 8; ++i) {
+    key.high = key.high << 8 | octets[i];
+    key.low = key.low << 8 | octets[i + 8];
+  }
+  return key;
+}
+
+/** \brief a Name being looked up, compared with entries through compareQueryWithData
+ */
+struct QueryProbe
+{
+  explicit
+  QueryProbe(const Name& queryName)
+    : name(queryName)
+  {
+    // the implicit digest of a full Name orders entries with equal Names, see compareQueryWithData
+    bool isFullName = !name.empty() && name[-1].isImplicitSha256Digest();
+    key = makeKey(name, isFullName ? name.size() - 1 : name.size());
+  }
+
+  /** \return negative, zero, or positive if the probe sorts before, at, or after \p entry
+   */
+  int
+  compare(const EntryImpl& entry) const
+  {
+    return compareQueryWithData(name, entry.getData());
+  }
+
+  const Name& name;
+  TableKey key;
+};
+
+/** \brief a Data being inserted, compared with entries through compareDataWithData
+ */
+struct DataProbe
+{
+  explicit
+  DataProbe(const Data& probeData)
+    : data(probeData)
+    , key(makeKey(data.getName(), data.getName().size()))
+  {
+  }
+
+  int
+  compare(const EntryImpl& entry) const
+  {
+    return compareDataWithData(data, entry.getData());
+  }
+
+  const Data& data;
+  TableKey key;
+};
+
+/** \return whether \p probe sorts after \p entry, whose inline key is \p key
+ */
+template<typename Probe>
+static bool
+isAfter(const Probe& probe, const TableKey& key, const EntryImpl& entry)
+{
+  if (!(key == probe.key)) {
+    return key < probe.key;
+  }
+  return probe.compare(entry) > 0;
+}
+
+TableIterator::TableIterator(const EntryImpl* entry)
+  : m_table(entry->m_leaf->table)
+  , m_entry(entry)
+  , m_pos(0)
+{
+}
+
+TableIterator&
+TableIterator::operator++()
+{
+  BOOST_ASSERT(m_entry != nullptr);
+
+  const TableLeaf* leaf = m_entry->m_leaf;
+  size_t pos = leaf->find(m_entry, m_pos) + 1;
+  if (pos == leaf->size) {
+    leaf = leaf->next;
+    pos = 0;
+  }
+
+  m_entry = leaf == nullptr ? nullptr : leaf->entries[pos];
+  m_pos = pos;
+  return *this;
+}
+
+TableIterator&
+TableIterator::operator--()
+{
+  const TableLeaf* leaf = nullptr;
+  size_t pos = 0;
+  if (m_entry == nullptr) {
+    BOOST_ASSERT(m_table != nullptr);
+    leaf = m_table->m_last;
+    pos = leaf->size;
+  }
+  else {
+    leaf = m_entry->m_leaf;
+    pos = leaf->find(m_entry, m_pos);
+  }
+
+  if (pos == 0) {
+    leaf = leaf->prev;
+    BOOST_ASSERT(leaf != nullptr);
+    pos = leaf->size;
+  }
+  BOOST_ASSERT(pos > 0);
+
+  m_pos = pos - 1;
+  m_entry = leaf->entries[m_pos];
+  return *this;
+}
+
+Table::Table()
+  : m_entryPool(256)
+  , m_size(0)
+{
+  m_root = m_first = m_last = this->makeLeaf();
+}
+
+Table::~Table()
+{
+  // nodes are released with their pools, but entries hold Data and must be destructed
+  for (TableLeaf* leaf = m_first; leaf != nullptr; leaf = leaf->next) {
+    for (size_t i = 0; i < leaf->size; ++i) {
+      m_entryPool.destroy(leaf->entries[i]);
+    }
+  }
+}
+
+template<typename Probe>
+std::pair<TableLeaf*, size_t>
+Table::findPosition(const Probe& probe) const
+{
+  TableNode* node = m_root;
+  while (!node->isLeaf) {
+    const TableInner* inner = static_cast<const TableInner*>(node);
+    size_t low = 1;
+    size_t high = inner->size;
+    while (low < high) {
+      size_t mid = (low + high) / 2;
+      if (isAfter(probe, inner->keys[mid], *inner->firsts[mid])) {
+        low = mid + 1;
+      }
+      else {
+        high = mid;
+      }
+    }
+    node = inner->children[low - 1];
+  }
+
+  TableLeaf* leaf = static_cast<TableLeaf*>(node);
+  size_t low = 0;
+  size_t high = leaf->size;
+  while (low < high) {
+    size_t mid = (low + high) / 2;
+    if (isAfter(probe, leaf->keys[mid], *leaf->entries[mid])) {
+      low = mid + 1;
+    }
+    else {
+      high = mid;
+    }
+  }
+  return {leaf, low};
+}
+
+Table::const_iterator
+Table::makeIterator(const TableLeaf* leaf, size_t pos) const
+{
+  if (pos == leaf->size) {
+    leaf = leaf->next;
+    pos = 0;
+  }
+  if (leaf == nullptr) {
+    return this->end();
+  }
+  return const_iterator(this, leaf->entries[pos], pos);
+}
+
+Table::const_iterator
+Table::lower_bound(const Name& queryName) const
+{
+  QueryProbe probe(queryName);
+  TableLeaf* leaf = nullptr;
+  size_t pos = 0;
+  std::tie(leaf, pos) = this->findPosition(probe);
+  return this->makeIterator(leaf, pos);
+}
+
+std::pair<Table::const_iterator, bool>
+Table::emplace(shared_ptr<const Data> data, bool isUnsolicited)
+{
+  BOOST_ASSERT(data != nullptr);
+
+  DataProbe probe(*data);
+  TableLeaf* leaf = nullptr;
+  size_t pos = 0;
+  std::tie(leaf, pos) = this->findPosition(probe);
+
+  const_iterator found = this->makeIterator(leaf, pos);
+  if (found != this->end() && probe.compare(*found) == 0) {
+    return {found, false};
+  }
+
+  EntryImpl* entry = m_entryPool.construct(std::move(data), isUnsolicited);
+  ++m_size;
+  return {this->insertEntry(leaf, pos, entry, probe.key), true};
+}
+
+void
+Table::erase(const_iterator it)
+{
+  BOOST_ASSERT(it != this->end());
+
+  EntryImpl* entry = const_cast<EntryImpl*>(it.m_entry);
+  TableLeaf* leaf = entry->m_leaf;
+  size_t pos = leaf->find(entry, it.m_pos);
+  std::copy(leaf->keys + pos + 1, leaf->keys + leaf->size, leaf->keys + pos);
+  std::copy(leaf->entries + pos + 1, leaf->entries + leaf->size, leaf->entries + pos);
+  --leaf->size;
+  --m_size;
+
+  if (leaf->size == 0) {
+    if (leaf != m_root) {
+      this->eraseNode(leaf);
+    }
+  }
+  else {
+    if (pos == 0) {
+      this->updateFirst(leaf, leaf->keys[0], leaf->entries[0]);
+    }
+    this->mergeIfUnderfull(leaf);
+  }
+
+  // the tree no longer refers to the entry
+  m_entryPool.destroy(entry);
+}
+
+TableLeaf*
+Table::makeLeaf()
+{
+  TableLeaf* leaf = m_leafPool.construct();
+  leaf->parent = nullptr;
+  leaf->size = 0;
+  leaf->isLeaf = true;
+  leaf->table = this;
+  leaf->prev = leaf->next = nullptr;
+  return leaf;
+}
+
+TableInner*
+Table::makeInner()
+{
+  TableInner* inner = m_innerPool.construct();
+  inner->parent = nullptr;
+  inner->size = 0;
+  inner->isLeaf = false;
+  return inner;
+}
+
+Table::const_iterator
+Table::insertEntry(TableLeaf* leaf, size_t pos, EntryImpl* entry, const TableKey& key)
+{
+  if (leaf->size == TableNode::CAPACITY) {
+    TableLeaf* right = this->splitLeaf(leaf);
+    if (pos > leaf->size) {
+      pos -= leaf->size;
+      leaf = right;
+    }
+  }
+
+  // only an entry sorting before every other one can become the first entry of a leaf,
+  // so no inner node needs to learn about the new entry
+  BOOST_ASSERT(pos > 0 || leaf == m_first);
+
+  std::copy_backward(leaf->keys + pos, leaf->keys + leaf->size, leaf->keys + leaf->size + 1);
+  std::copy_backward(leaf->entries + pos, leaf->entries + leaf->size,
+                     leaf->entries + leaf->size + 1);
+  leaf->keys[pos] = key;
+  leaf->entries[pos] = entry;
+  entry->m_leaf = leaf;
+  ++leaf->size;
+  return const_iterator(this, entry, pos);
+}
+
+TableLeaf*
+Table::splitLeaf(TableLeaf* leaf)
+{
+  TableLeaf* right = this->makeLeaf();
+  size_t half = leaf->size / 2;
+  std::copy(leaf->keys + half, leaf->keys + leaf->size, right->keys);
+  std::copy(leaf->entries + half, leaf->entries + leaf->size, right->entries);
+  right->size = leaf->size - half;
+  leaf->size = half;
+  adoptEntries(right, 0, right->size);
+
+  right->prev = leaf;
+  right->next = leaf->next;
+  if (leaf->next != nullptr) {
+    leaf->next->prev = right;
+  }
+  else {
+    m_last = right;
+  }
+  leaf->next = right;
+
+  this->insertChild(leaf, right, right->keys[0], right->entries[0]);
+  return right;
+}
+
+TableInner*
+Table::splitInner(TableInner* inner)
+{
+  TableInner* right = this->makeInner();
+  size_t half = inner->size / 2;
+  std::copy(inner->keys + half, inner->keys + inner->size, right->keys);
+  std::copy(inner->firsts + half, inner->firsts + inner->size, right->firsts);
+  std::copy(inner->children + half, inner->children + inner->size, right->children);
+  right->size = inner->size - half;
+  inner->size = half;
+  adoptChildren(right, 0, right->size);
+
+  // the first entry of the moved children becomes the first entry of the new node
+  this->insertChild(inner, right, right->keys[0], right->firsts[0]);
+  return right;
+}
+
+void
+Table::insertChild(TableNode* left, TableNode* right, const TableKey& key, EntryImpl* first)
+{
+  TableInner* parent = left->parent;
+  if (parent == nullptr) {
+    BOOST_ASSERT(left == m_root);
+    parent = this->makeInner();
+    parent->children[0] = left;
+    parent->size = 1;
+    left->parent = parent;
+    m_root = parent;
+  }
+
+  size_t pos = getChildIndex(left) + 1;
+  if (parent->size == TableNode::CAPACITY) {
+    TableInner* sibling = this->splitInner(parent);
+    if (pos > parent->size) {
+      pos -= parent->size;
+      parent = sibling;
+    }
+  }
+
+  std::copy_backward(parent->keys + pos, parent->keys + parent->size,
+                     parent->keys + parent->size + 1);
+  std::copy_backward(parent->firsts + pos, parent->firsts + parent->size,
+                     parent->firsts + parent->size + 1);
+  std::copy_backward(parent->children + pos, parent->children + parent->size,
+                     parent->children + parent->size + 1);
+  parent->keys[pos] = key;
+  parent->firsts[pos] = first;
+  parent->children[pos] = right;
+  right->parent = parent;
+  ++parent->size;
+}
+
+void
+Table::updateFirst(TableNode* node, const TableKey& key, EntryImpl* first)
+{
+  // the first entry of a subtree is recorded only in the lowest ancestor where the subtree
+  // is not the first child
+  for (; node->parent != nullptr; node = node->parent) {
+    size_t index = getChildIndex(node);
+    if (index > 0) {
+      node->parent->keys[index] = key;
+      node->parent->firsts[index] = first;
+      return;
+    }
+  }
+}
+
+void
+Table::eraseNode(TableNode* node)
+{
+  BOOST_ASSERT(node != m_root && node->size == 0);
+
+  TableInner* parent = node->parent;
+  size_t index = getChildIndex(node);
+  if (node->isLeaf) {
+    TableLeaf* leaf = static_cast<TableLeaf*>(node);
+    (leaf->prev != nullptr ? leaf->prev->next : m_first) = leaf->next;
+    (leaf->next != nullptr ? leaf->next->prev : m_last) = leaf->prev;
+    m_leafPool.destroy(leaf);
+  }
+  else {
+    m_innerPool.destroy(static_cast<TableInner*>(node));
+  }
+
+  std::copy(parent->keys + index + 1, parent->keys + parent->size, parent->keys + index);
+  std::copy(parent->firsts + index + 1, parent->firsts + parent->size, parent->firsts + index);
+  std::copy(parent->children + index + 1, parent->children + parent->size,
+            parent->children + index);
+  --parent->size;
+
+  if (parent->size == 0) {
+    this->eraseNode(parent);
+    return;
+  }
+  if (index == 0) {
+    // the former second child is now the first, so the subtree of parent starts with its entry
+    this->updateFirst(parent, parent->keys[0], parent->firsts[0]);
+  }
+  this->mergeIfUnderfull(parent);
+}
+
+void
+Table::mergeIfUnderfull(TableNode* node)
+{
+  if (node == m_root) {
+    while (!m_root->isLeaf && m_root->size == 1) {
+      TableInner* root = static_cast<TableInner*>(m_root);
+      m_root = root->children[0];
+      m_root->parent = nullptr;
+      m_innerPool.destroy(root);
+    }
+    return;
+  }
+
+  if (node->size >= TableNode::MIN_SIZE) {
+    return;
+  }
+
+  TableInner* parent = node->parent;
+  size_t index = getChildIndex(node);
+  if (index + 1 < parent->size &&
+      node->size + parent->children[index + 1]->size <= TableNode::CAPACITY) {
+    this->mergeChildren(parent, index);
+  }
+  else if (index > 0 &&
+           parent->children[index - 1]->size + node->size <= TableNode::CAPACITY) {
+    this->mergeChildren(parent, index - 1);
+  }
+}
+
+void
+Table::mergeChildren(TableInner* parent, size_t index)
+{
+  TableNode* left = parent->children[index];
+  TableNode* right = parent->children[index + 1];
+  size_t leftSize = left->size;
+
+  if (left->isLeaf) {
+    TableLeaf* leftLeaf = static_cast<TableLeaf*>(left);
+    TableLeaf* rightLeaf = static_cast<TableLeaf*>(right);
+    std::copy(rightLeaf->keys, rightLeaf->keys + rightLeaf->size, leftLeaf->keys + leftSize);
+    std::copy(rightLeaf->entries, rightLeaf->entries + rightLeaf->size,
+              leftLeaf->entries + leftSize);
+    leftLeaf->size += rightLeaf->size;
+    adoptEntries(leftLeaf, leftSize, leftLeaf->size);
+
+    leftLeaf->next = rightLeaf->next;
+    (rightLeaf->next != nullptr ? rightLeaf->next->prev : m_last) = leftLeaf;
+    m_leafPool.destroy(rightLeaf);
+  }
+  else {
+    TableInner* leftInner = static_cast<TableInner*>(left);
+    TableInner* rightInner = static_cast<TableInner*>(right);
+    // the first entry of the right node is recorded in parent
+    std::copy(rightInner->keys, rightInner->keys + rightInner->size, leftInner->keys + leftSize);
+    std::copy(rightInner->firsts, rightInner->firsts + rightInner->size,
+              leftInner->firsts + leftSize);
+    std::copy(rightInner->children, rightInner->children + rightInner->size,
+              leftInner->children + leftSize);
+    leftInner->keys[leftSize] = parent->keys[index + 1];
+    leftInner->firsts[leftSize] = parent->firsts[index + 1];
+    leftInner->size += rightInner->size;
+    adoptChildren(leftInner, leftSize, leftInner->size);
+    m_innerPool.destroy(rightInner);
+  }
+
+  std::copy(parent->keys + index + 2, parent->keys + parent->size, parent->keys + index + 1);
+  std::copy(parent->firsts + index + 2, parent->firsts + parent->size, parent->firsts + index + 1);
+  std::copy(parent->children + index + 2, parent->children + parent->size,
+            parent->children + index + 1);
+  --parent->size;
+
+  this->mergeIfUnderfull(parent);
+}
+
+void
+Table::adoptEntries(TableLeaf* leaf, size_t first, size_t last)
+{
+  for (size_t i = first; i < last; ++i) {
+    leaf->entries[i]->m_leaf = leaf;
+  }
+}
+
+void
+Table::adoptChildren(TableInner* inner, size_t first, size_t last)
+{
+  for (size_t i = first; i < last; ++i) {
+    inner->children[i]->parent = inner;
+  }
+}
+
+size_t
+Table::getChildIndex(const TableNode* child)
+{
+  const TableInner* parent = child->parent;
+  BOOST_ASSERT(parent != nullptr);
+  size_t index = std::find(parent->children, parent->children + parent->size, child) -
+                 parent->children;
+  BOOST_ASSERT(index < parent->size);
+  return index;
+}
+
+} // namespace cs
+} // namespace nfd
@@ -0,0 +1,277 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2018,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NFD_DAEMON_TABLE_CS_TABLE_HPP
+#define NFD_DAEMON_TABLE_CS_TABLE_HPP
+
+#include "cs-internal.hpp"
+#include "cs-entry-impl.hpp"
+#include "object-pool.hpp"
+
+#include <algorithm>
+
+namespace nfd {
+namespace cs {
+
+/** \brief inline key of an entry in Table nodes
+ *
+ *  The key holds the first 16 octets of the TLV encoding of the Name components, zero-padded.
+ *  The canonical order of Names is the lexicographic order of these encodings, so a key that
+ *  differs decides a comparison without dereferencing the entry; equal keys fall back to
+ *  comparing the Names.
+ */
+struct TableKey
+{
+  uint64_t high;
+  uint64_t low;
+
+  bool
+  operator<(const TableKey& other) const
+  {
+    return high < other.high || (high == other.high && low < other.low);
+  }
+
+  bool
+  operator==(const TableKey& other) const
+  {
+    return high == other.high && low == other.low;
+  }
+};
+
+struct TableInner;
+
+/** \brief common part of Table nodes
+ */
+struct TableNode
+{
+  /** \brief maximum number of entries in a leaf, or of children of an inner node
+   */
+  static const size_t CAPACITY = 32;
+
+  /** \brief a node with fewer entries or children is merged with a sibling, if they fit in one
+   */
+  static const size_t MIN_SIZE = CAPACITY / 4;
+
+  TableInner* parent; ///< nullptr for the root
+  size_t size; ///< number of entries of a leaf, or number of children of an inner node
+  bool isLeaf;
+};
+
+/** \brief a Table leaf, holding up to CAPACITY entries in order
+ */
+struct TableLeaf : TableNode
+{
+  /** \return position of \p entry in this leaf
+   *  \param hint position to check first
+   *  \pre the entry is in this leaf
+   */
+  size_t
+  find(const EntryImpl* entry, size_t hint) const
+  {
+    if (hint < size && entries[hint] == entry) {
+      return hint;
+    }
+    size_t pos = std::find(entries, entries + size, entry) - entries;
+    BOOST_ASSERT(pos < size);
+    return pos;
+  }
+
+  const Table* table;
+  TableLeaf* prev;
+  TableLeaf* next;
+  TableKey keys[CAPACITY];
+  EntryImpl* entries[CAPACITY];
+};
+
+/** \brief a Table inner node
+ *
+ *  firsts[i] is the first entry in the subtree of children[i], and keys[i] is its key;
+ *  both are unused for i = 0. A lookup descends into the last child whose first entry sorts
+ *  before the probe.
+ */
+struct TableInner : TableNode
+{
+  TableKey keys[CAPACITY];
+  EntryImpl* firsts[CAPACITY];
+  TableNode* children[CAPACITY];
+};
+
+/** \brief the ContentStore table, a B+-tree of entries ordered by full Name
+ *
+ *  Nodes hold inline keys and entry pointers in contiguous arrays, so a lookup or an ordered
+ *  scan reads a few cache lines per node, and dereferences an entry only where inline keys tie.
+ *  Leaves are linked to their neighbours for ordered scans in either direction.
+ *
+ *  Entries are allocated from a pool owned by the table, and never move, so that iterators,
+ *  references, and the EntryQueue links inside entries stay valid across insertions and
+ *  erasures of other entries. Every pool of the table is released when the table is destructed.
+ */
+class Table : noncopyable
+{
+public:
+  typedef TableIterator const_iterator;
+
+  Table();
+
+  ~Table();
+
+  size_t
+  size() const
+  {
+    return m_size;
+  }
+
+  bool
+  empty() const
+  {
+    return m_size == 0;
+  }
+
+  const_iterator
+  begin() const
+  {
+    return this->makeIterator(m_first, 0);
+  }
+
+  const_iterator
+  end() const
+  {
+    return const_iterator(this, nullptr, 0);
+  }
+
+  /** \return the first entry that does not sort before \p queryName, or end()
+   *
+   *  \p queryName is compared with entries through compareQueryWithData.
+   */
+  const_iterator
+  lower_bound(const Name& queryName) const;
+
+  /** \brief inserts an entry for \p data, unless an entry for the same Data exists
+   *  \return an iterator to the entry for \p data, and whether it has been inserted
+   */
+  std::pair<const_iterator, bool>
+  emplace(shared_ptr<const Data> data, bool isUnsolicited);
+
+  /** \brief erases and destructs an entry
+   */
+  void
+  erase(const_iterator it);
+
+private:
+  /** \return the position of the first entry that does not sort before \p probe;
+   *          this can be the end of a leaf, and the entry is then the first of the next leaf
+   */
+  template<typename Probe>
+  std::pair<TableLeaf*, size_t>
+  findPosition(const Probe& probe) const;
+
+  /** \return an iterator to the entry at \p pos in \p leaf, or to the next leaf if \p pos is
+   *          the end of \p leaf
+   */
+  const_iterator
+  makeIterator(const TableLeaf* leaf, size_t pos) const;
+
+  TableLeaf*
+  makeLeaf();
+
+  TableInner*
+  makeInner();
+
+  /** \brief inserts \p entry at \p pos in \p leaf, splitting the leaf if it is full
+   *  \return an iterator to the entry
+   */
+  const_iterator
+  insertEntry(TableLeaf* leaf, size_t pos, EntryImpl* entry, const TableKey& key);
+
+  /** \brief moves the upper half of a full leaf to a new leaf after it
+   *  \return the new leaf
+   */
+  TableLeaf*
+  splitLeaf(TableLeaf* leaf);
+
+  /** \brief moves the upper half of the children of a full inner node to a new node after it
+   *  \return the new node
+   */
+  TableInner*
+  splitInner(TableInner* inner);
+
+  /** \brief inserts \p right, whose first entry is \p first, after its sibling \p left
+   */
+  void
+  insertChild(TableNode* left, TableNode* right, const TableKey& key, EntryImpl* first);
+
+  /** \brief records \p first as the first entry in the subtree of \p node
+   */
+  void
+  updateFirst(TableNode* node, const TableKey& key, EntryImpl* first);
+
+  /** \brief removes an empty non-root node from its parent, and destructs it
+   */
+  void
+  eraseNode(TableNode* node);
+
+  /** \brief merges \p node with a sibling if it has fewer than MIN_SIZE entries or children,
+   *         or replaces the root with its only child
+   */
+  void
+  mergeIfUnderfull(TableNode* node);
+
+  /** \brief moves the entries or children of parent->children[index + 1] to
+   *         parent->children[index], and destructs the emptied node
+   */
+  void
+  mergeChildren(TableInner* parent, size_t index);
+
+  /** \brief sets the leaf of entries [first, last) of \p leaf
+   */
+  static void
+  adoptEntries(TableLeaf* leaf, size_t first, size_t last);
+
+  /** \brief sets the parent of children [first, last) of \p inner
+   */
+  static void
+  adoptChildren(TableInner* inner, size_t first, size_t last);
+
+  /** \return position of \p child among the children of its parent
+   */
+  static size_t
+  getChildIndex(const TableNode* child);
+
+private:
+  ObjectPool<EntryImpl> m_entryPool;
+  ObjectPool<TableLeaf> m_leafPool;
+  ObjectPool<TableInner> m_innerPool;
+  TableNode* m_root;
+  TableLeaf* m_first; ///< leftmost leaf
+  TableLeaf* m_last; ///< rightmost leaf
+  size_t m_size;
+
+  friend class TableIterator;
+};
+
+} // namespace cs
+} // namespace nfd
+
+#endif // NFD_DAEMON_TABLE_CS_TABLE_HPP
@@ -28,6 +28,8 @@
 #include "core/asserts.hpp"
 #include "core/logger.hpp"
 #include <ndn-cxx/lp/tags.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <cstring>
 
 namespace nfd {
 namespace cs {
@@ -36,17 +38,6 @@ NFD_ASSERT_FORWARD_ITERATOR(Cs::const_iterator);
 
 NFD_LOG_INIT("ContentStore");
 
-int hitRateRatio = 0;
-int missRateRatio = 0;
-
-int hitRateRatio1 = 0;
-int hitRateRatio2 = 0;
-int hitRateRatio3 = 0;
-
-int missRateRatio1 = 0;
-int missRateRatio2 = 0;
-int missRateRatio3 = 0;
-
 unique_ptr<Policy>
 makeDefaultPolicy()
 {
@@ -55,7 +46,8 @@ makeDefaultPolicy()
 }
 
 Cs::Cs(size_t nMaxPackets)
-  : m_shouldAdmit(true)
+  : m_nBytes(0)
+  , m_shouldAdmit(true)
   , m_shouldServe(true)
 {
   this->setPolicyImpl(makeDefaultPolicy());
@@ -79,6 +71,18 @@ Cs::insert(const Data& data, bool isUnsolicited)
     }
   }
 
+  if (m_cacheDecision != nullptr && !m_cacheDecision->shouldCache(data)) {
+    ++m_counters.nDeclined;
+    NFD_LOG_DEBUG("insert " << data.getName() << " declined by " << m_cacheDecision->getName());
+    return;
+  }
+
+  if (m_admissionFilter != nullptr && !this->passesAdmissionFilter(data)) {
+    ++m_counters.nAdmissionRejects;
+    NFD_LOG_DEBUG("insert " << data.getName() << " rejected by admission filter");
+    return;
+  }
+
   iterator it;
   bool isNewEntry = false;
   std::tie(it, isNewEntry) = m_table.emplace(data.shared_from_this(), isUnsolicited);
@@ -92,9 +96,13 @@ Cs::insert(const Data& data, bool isUnsolicited)
       entry.unsetUnsolicited();
     }
 
+    ++m_counters.nRefreshes;
     m_policy->afterRefresh(it);
   }
   else {
+    ++m_counters.nInserts;
+    m_nBytes += entry.getWireSize();
+    this->insertToIndex(it);
     m_policy->afterInsert(it);
   }
 
@@ -103,6 +111,27 @@ Cs::insert(const Data& data, bool isUnsolicited)
 
 }
 
+bool
+Cs::passesAdmissionFilter(const Data& data) const
+{
+  BOOST_ASSERT(m_admissionFilter != nullptr);
+
+  if (m_table.size() < m_policy->getLimit() &&
+      m_nBytes + data.wireEncode().size() <= m_policy->getByteLimit()) {
+    return true;
+  }
+  if (m_table.empty() || m_exactIndex.count(&data.getName()) > 0) {
+    return true;
+  }
+
+  // only the first victim is compared, see passesAdmissionFilter declaration
+  iterator victim = m_policy->peekVictim();
+  bool shouldAdmit = m_admissionFilter->shouldAdmit(data.getName(), victim->getName());
+  NFD_LOG_TRACE("  admission " << data.getName() << " vs " << victim->getName() <<
+                (shouldAdmit ? " admit" : " reject"));
+  return shouldAdmit;
+}
+
 void
 Cs::find(const Interest& interest,
          const HitCallback& hitCallback,
@@ -116,79 +145,76 @@ Cs::find(const Interest& interest,
     return;
   }
   const Name& prefix = interest.getName();
+  if (m_admissionFilter != nullptr) {
+    m_admissionFilter->recordAccess(prefix);
+  }
+
   bool isRightmost = interest.getChildSelector() == 1;
   NFD_LOG_DEBUG("find " << prefix << (isRightmost ? " R" : " L"));
 
-  iterator first = m_table.lower_bound(prefix);
-  iterator last = m_table.end();
-  if (prefix.size() > 0) {
-    last = m_table.lower_bound(prefix.getSuccessor());
-  }
-
-  iterator match = last;
-  if (isRightmost) {
-    match = this->findRightmost(interest, first, last);
+  iterator match = m_table.end();
+  if (!isRightmost) {
+    match = this->findExact(interest);
   }
-  else {
-    match = this->findLeftmost(interest, first, last);
-  }
-
-  if (match == last) {
-
-    if (m_policy->getName() == "lrfu" || m_policy->getName() == "lru" || m_policy->getName() == "priority_fifo"){
-        std::string prefdata = prefix.toUri().c_str();
 
-        std::string delimiter = "%";
-        std::string pref = prefdata.substr(0, prefdata.find(delimiter));
+  if (match == m_table.end()) {
+    iterator first = m_table.lower_bound(prefix);
+    iterator last = m_table.end();
+    if (prefix.size() > 0) {
+      last = m_table.lower_bound(prefix.getSuccessor());
+    }
 
-        if(pref == "/prefix/"){
-          missRateRatio1++;
-        }
-        else if(pref == "/prefix2/"){
-          missRateRatio2++;
-        }
-        else if(pref == "/prefix3/"){
-          missRateRatio3++;
-        }
-      missRateRatio ++;        
-      }   
+    if (isRightmost) {
+      match = this->findRightmost(interest, first, last);
+    }
+    else {
+      match = this->findLeftmost(interest, first, last);
+    }
 
-    NFD_LOG_DEBUG(" TotalMiss + Routing Lookup : " << missRateRatio);
-    NFD_LOG_DEBUG("  Miss P1: " << missRateRatio1<< " Miss P2: " << missRateRatio2<< " Miss P3: " <<missRateRatio3); 
+    if (match == last) {
+      match = m_table.end();
+    }
+  }
 
+  if (match == m_table.end()) {
+    ++m_counters.nMisses;
+    NFD_LOG_DEBUG(" TotalMiss + Routing Lookup : " << m_counters.nMisses);
+    if (m_prefixCounters != nullptr) {
+      m_prefixCounters->countMiss(prefix);
+    }
 
-    // missRateRatio ++;
-    // NFD_LOG_DEBUG("  cache miss" << " missRateRatio: " << missRateRatio);
     missCallback(interest);
     return;
   }
 
-  hitRateRatio ++;
-  if (m_policy->getName() == "lrfu" || m_policy->getName() == "lru" || m_policy->getName() == "priority_fifo"){
-      std::string prefdata = prefix.toUri().c_str();
+  ++m_counters.nHits;
+  NFD_LOG_DEBUG(" TotalHit : " << m_counters.nHits);
+  if (m_prefixCounters != nullptr) {
+    m_prefixCounters->countHit(prefix);
+  }
 
-      std::string delimiter = "%";
-      std::string pref = prefdata.substr(0, prefdata.find(delimiter));
 
-      if(pref == "/prefix/"){
-        hitRateRatio1++;
-      }
-      else if(pref == "/prefix2/"){
-        hitRateRatio2++;
-      }
-      else if(pref == "/prefix3/"){
-        hitRateRatio3++;
-      }
-    }   
+  m_policy->beforeUse(match);
+  if (m_cacheDecision == nullptr) {
+    hitCallback(interest, match->getData());
+    return;
+  }
 
-  NFD_LOG_DEBUG(" TotalHit : " << hitRateRatio);
-  NFD_LOG_DEBUG("  Hit P1: " << hitRateRatio1<< " Hit P2: " << hitRateRatio2<< " Hit P3: " <<hitRateRatio3); 
+  // the stored Data is shared by later hits, so the decision returns a copy if it changes tags
+  shared_ptr<const Data> served = m_cacheDecision->beforeServe(match->getData());
+  hitCallback(interest, *served);
+}
 
+iterator
+Cs::findExact(const Interest& interest) const
+{
+  auto found = m_exactIndex.find(&interest.getName());
+  if (found == m_exactIndex.end() || !found->second->canSatisfy(interest)) {
+    return m_table.end();
+  }
 
-  // hitRateRatio ++;
-  // NFD_LOG_DEBUG("  cache hit " << match->getName()<< " hitRateRatio: " << hitRateRatio);
-  m_policy->beforeUse(match);
-  hitCallback(interest, match->getData());
+  NFD_LOG_TRACE("  find-exact " << found->second->getFullName());
+  return found->second;
 }
 
 iterator
@@ -250,8 +276,36 @@ Cs::setPolicy(unique_ptr<Policy> policy)
   BOOST_ASSERT(policy != nullptr);
   BOOST_ASSERT(m_policy != nullptr);
   size_t limit = m_policy->getLimit();
+  size_t byteLimit = m_policy->getByteLimit();
+  size_t lowWatermark = m_policy->getConfiguredLowWatermark();
+  std::vector<Policy::LoadedEntry> entries = this->getEntriesByLastUpdate();
+
+  // the previous policy detaches every entry when it is destructed
   this->setPolicyImpl(std::move(policy));
   m_policy->setLimit(limit);
+  m_policy->setByteLimit(byteLimit);
+  m_policy->setLowWatermark(lowWatermark);
+  if (!entries.empty()) {
+    m_policy->afterLoad(entries);
+  }
+}
+
+std::vector<Policy::LoadedEntry>
+Cs::getEntriesByLastUpdate() const
+{
+  std::vector<Policy::LoadedEntry> entries;
+  entries.reserve(m_table.size());
+  for (iterator it = m_table.begin(); it != m_table.end(); ++it) {
+    entries.push_back({it, m_policy->getEntryScore(it)});
+  }
+
+  // Entry::getStaleTime() minus freshness period is the time of last insertion or refresh
+  std::stable_sort(entries.begin(), entries.end(),
+    [] (const Policy::LoadedEntry& a, const Policy::LoadedEntry& b) {
+      return a.it->getStaleTime() - time::milliseconds(a.it->getData().getFreshnessPeriod()) <
+             b.it->getStaleTime() - time::milliseconds(b.it->getData().getFreshnessPeriod());
+    });
+  return entries;
 }
 
 void
@@ -260,15 +314,254 @@ Cs::setPolicyImpl(unique_ptr<Policy> policy)
   NFD_LOG_DEBUG("set-policy " << policy->getName());
   m_policy = std::move(policy);
   m_beforeEvictConnection = m_policy->beforeEvict.connect([this] (iterator it) {
-      m_table.erase(it);
+      ++m_counters.nEvictions;
+      this->eraseEntry(it);
 
       // NFD_LOG_INFO("Erased " <<it->getName());    
     });
+  m_beforeEvictBatchConnection = m_policy->beforeEvictBatch.connect(
+    [this] (const std::vector<iterator>& victims) {
+      for (iterator it : victims) {
+        ++m_counters.nEvictions;
+        this->eraseEntry(it);
+      }
+    });
 
   m_policy->setCs(this);
   BOOST_ASSERT(m_policy->getCs() == this);
 }
 
+void
+Cs::insertToIndex(iterator it)
+{
+  bool isNew = false;
+  ExactIndex::iterator found;
+  std::tie(found, isNew) = m_exactIndex.emplace(&it->getName(), it);
+  if (!isNew && *it < *found->second) {
+    // the key refers to the Name in the mapped entry, so both must be replaced together
+    m_exactIndex.erase(found);
+    m_exactIndex.emplace(&it->getName(), it);
+  }
+}
+
+void
+Cs::eraseFromIndex(iterator it)
+{
+  auto found = m_exactIndex.find(&it->getName());
+  BOOST_ASSERT(found != m_exactIndex.end());
+  if (found->second != it) {
+    return;
+  }
+
+  // entries with the same Name are adjacent in the table, ordered by implicit digest
+  m_exactIndex.erase(found);
+  iterator next = std::next(it);
+  if (next != m_table.end() && next->getName() == it->getName()) {
+    m_exactIndex.emplace(&next->getName(), next);
+  }
+}
+
+void
+Cs::eraseEntry(iterator it)
+{
+  m_nBytes -= it->getWireSize();
+  this->eraseFromIndex(it);
+  m_table.erase(it);
+}
+
+/** \brief snapshot file layout, in host byte order
+ *
+ *  The file starts with SNAPSHOT_MAGIC and the number of records, as uint64_t.
+ *  Each record is a SnapshotRecordHeader followed by the Data wire encoding.
+ */
+static const char SNAPSHOT_MAGIC[8] = {'N', 'D', 'N', 'C', 'S', 'S', 'N', '1'};
+
+struct SnapshotRecordHeader
+{
+  uint32_t wireSize;
+  uint8_t isUnsolicited;
+  int64_t freshnessLeft; ///< stale time minus snapshot time, in milliseconds; may be negative
+  double score; ///< Policy::getEntryScore() at snapshot time
+};
+
+static const size_t SNAPSHOT_HEADER_SIZE = sizeof(SNAPSHOT_MAGIC) + sizeof(uint64_t);
+static const size_t SNAPSHOT_RECORD_HEADER_SIZE = 4 + 1 + 8 + 8;
+
+static uint8_t*
+writeRecordHeader(uint8_t* pos, const SnapshotRecordHeader& header)
+{
+  std::memcpy(pos, &header.wireSize, 4);
+  std::memcpy(pos + 4, &header.isUnsolicited, 1);
+  std::memcpy(pos + 5, &header.freshnessLeft, 8);
+  std::memcpy(pos + 13, &header.score, 8);
+  return pos + SNAPSHOT_RECORD_HEADER_SIZE;
+}
+
+static const uint8_t*
+readRecordHeader(const uint8_t* pos, SnapshotRecordHeader& header)
+{
+  std::memcpy(&header.wireSize, pos, 4);
+  std::memcpy(&header.isUnsolicited, pos + 4, 1);
+  std::memcpy(&header.freshnessLeft, pos + 5, 8);
+  std::memcpy(&header.score, pos + 13, 8);
+  return pos + SNAPSHOT_RECORD_HEADER_SIZE;
+}
+
+void
+Cs::saveSnapshot(const std::string& filename) const
+{
+  std::vector<Policy::LoadedEntry> entries = this->getEntriesByLastUpdate();
+  size_t fileSize = SNAPSHOT_HEADER_SIZE + entries.size() * SNAPSHOT_RECORD_HEADER_SIZE;
+  for (const Policy::LoadedEntry& entry : entries) {
+    fileSize += entry.it->getWireSize();
+  }
+
+  boost::iostreams::mapped_file_params params(filename);
+  params.flags = boost::iostreams::mapped_file::readwrite;
+  params.new_file_size = fileSize;
+  boost::iostreams::mapped_file_sink file;
+  try {
+    file.open(params);
+  }
+  catch (const std::ios_base::failure& e) {
+    BOOST_THROW_EXCEPTION(Error("cannot write CS snapshot " + filename + ": " + e.what()));
+  }
+
+  uint8_t* pos = reinterpret_cast<uint8_t*>(file.data());
+  std::memcpy(pos, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+  uint64_t nRecords = entries.size();
+  std::memcpy(pos + sizeof(SNAPSHOT_MAGIC), &nRecords, sizeof(nRecords));
+  pos += SNAPSHOT_HEADER_SIZE;
+
+  time::steady_clock::TimePoint now = time::steady_clock::now();
+  for (const Policy::LoadedEntry& entry : entries) {
+    const Block& wire = entry.it->getData().wireEncode();
+    SnapshotRecordHeader header;
+    header.wireSize = static_cast<uint32_t>(wire.size());
+    header.isUnsolicited = entry.it->isUnsolicited() ? 1 : 0;
+    header.freshnessLeft = time::duration_cast<time::milliseconds>(
+                             entry.it->getStaleTime() - now).count();
+    header.score = entry.score;
+    pos = writeRecordHeader(pos, header);
+    std::memcpy(pos, wire.wire(), wire.size());
+    pos += wire.size();
+  }
+  BOOST_ASSERT(pos == reinterpret_cast<uint8_t*>(file.data()) + fileSize);
+
+  NFD_LOG_INFO("saved " << entries.size() << " entries to snapshot " << filename);
+}
+
+size_t
+Cs::loadSnapshot(const std::string& filename)
+{
+  boost::iostreams::mapped_file_source file;
+  try {
+    file.open(filename);
+  }
+  catch (const std::ios_base::failure& e) {
+    BOOST_THROW_EXCEPTION(Error("cannot read CS snapshot " + filename + ": " + e.what()));
+  }
+
+  const uint8_t* begin = reinterpret_cast<const uint8_t*>(file.data());
+  const uint8_t* end = begin + file.size();
+  uint64_t nRecords = 0;
+  if (file.size() < SNAPSHOT_HEADER_SIZE ||
+      std::memcmp(begin, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+    BOOST_THROW_EXCEPTION(Error(filename + " is not a CS snapshot"));
+  }
+  std::memcpy(&nRecords, begin + sizeof(SNAPSHOT_MAGIC), sizeof(nRecords));
+
+  // locate every record first, so that the most recent ones can be kept within the limits
+  std::vector<std::pair<SnapshotRecordHeader, const uint8_t*>> records;
+  records.reserve(std::min<uint64_t>(nRecords, file.size() / SNAPSHOT_RECORD_HEADER_SIZE));
+  const uint8_t* pos = begin + SNAPSHOT_HEADER_SIZE;
+  for (uint64_t i = 0; i < nRecords; ++i) {
+    SnapshotRecordHeader header;
+    if (static_cast<size_t>(end - pos) < SNAPSHOT_RECORD_HEADER_SIZE) {
+      BOOST_THROW_EXCEPTION(Error("CS snapshot " + filename + " is truncated"));
+    }
+    pos = readRecordHeader(pos, header);
+    if (static_cast<size_t>(end - pos) < header.wireSize) {
+      BOOST_THROW_EXCEPTION(Error("CS snapshot " + filename + " is truncated"));
+    }
+    records.emplace_back(header, pos);
+    pos += header.wireSize;
+  }
+
+  size_t limit = m_policy->getLimit();
+  size_t byteLimit = m_policy->getByteLimit();
+  size_t nFree = limit > m_table.size() ? limit - m_table.size() : 0;
+  size_t nFreeBytes = byteLimit > m_nBytes ? byteLimit - m_nBytes : 0;
+  auto first = records.end();
+  while (first != records.begin() && nFree > 0 &&
+         std::prev(first)->first.wireSize <= nFreeBytes) {
+    --first;
+    --nFree;
+    nFreeBytes -= first->first.wireSize;
+  }
+
+  // decode before inserting anything, so that a malformed snapshot leaves CS unchanged
+  std::vector<shared_ptr<Data>> dataList;
+  dataList.reserve(std::distance(first, records.end()));
+  for (auto record = first; record != records.end(); ++record) {
+    try {
+      dataList.push_back(make_shared<Data>(Block(record->second, record->first.wireSize)));
+    }
+    catch (const tlv::Error& e) {
+      BOOST_THROW_EXCEPTION(Error("CS snapshot " + filename + " has malformed Data: " + e.what()));
+    }
+  }
+
+  time::steady_clock::TimePoint now = time::steady_clock::now();
+  std::vector<Policy::LoadedEntry> loaded;
+  loaded.reserve(dataList.size());
+  auto data = dataList.begin();
+  for (auto record = first; record != records.end(); ++record, ++data) {
+    iterator it;
+    bool isNewEntry = false;
+    std::tie(it, isNewEntry) = m_table.emplace(*data, record->first.isUnsolicited != 0);
+    if (!isNewEntry) {
+      continue;
+    }
+    EntryImpl& entry = const_cast<EntryImpl&>(*it);
+    entry.setStaleTime(now + time::milliseconds(record->first.freshnessLeft));
+    m_nBytes += entry.getWireSize();
+    this->insertToIndex(it);
+    loaded.push_back({it, record->first.score});
+  }
+
+  if (!loaded.empty()) {
+    m_policy->afterLoad(loaded);
+  }
+
+  NFD_LOG_INFO("loaded " << loaded.size() << " of " << nRecords <<
+               " entries from snapshot " << filename);
+  return loaded.size();
+}
+
+void
+Cs::setAdmissionFilter(unique_ptr<AdmissionFilter> filter)
+{
+  NFD_LOG_DEBUG("set-admission-filter " << (filter == nullptr ? "none" : "tinylfu"));
+  m_admissionFilter = std::move(filter);
+}
+
+void
+Cs::setCacheDecision(unique_ptr<CacheDecision> decision)
+{
+  NFD_LOG_DEBUG("set-cache-decision " << (decision == nullptr ? "none" : decision->getName()));
+  m_cacheDecision = std::move(decision);
+}
+
+PrefixCounters&
+Cs::getPrefixCounters()
+{
+  if (m_prefixCounters == nullptr) {
+    m_prefixCounters = make_unique<PrefixCounters>();
+  }
+  return *m_prefixCounters;
+}
+
 void
 Cs::enableAdmit(bool shouldAdmit)
 {
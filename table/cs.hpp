@@ -30,7 +30,7 @@
  *  This ContentStore implementation consists of two data structures,
  *  a Table, and a set of cleanup queues.
  *
- *  The Table is a container (std::set) sorted by full Names of stored Data packets.
+ *  The Table is a B+-tree (cs::Table) sorted by full Names of stored Data packets.
  *  Data packets are wrapped in Entry objects.
  *  Each Entry contain the Data packet itself,
  *  and a few addition attributes such as the staleness of the Data packet.
@@ -49,9 +49,15 @@
 #define NFD_DAEMON_TABLE_CS_HPP
 
 #include "cs-policy.hpp"
+#include "cs-admission-filter.hpp"
+#include "cs-cache-decision.hpp"
 #include "cs-internal.hpp"
 #include "cs-entry-impl.hpp"
+#include "cs-table.hpp"
+#include "cs-counters.hpp"
+#include "cs-prefix-counters.hpp"
 #include <ndn-cxx/util/signal.hpp>
+#include <unordered_map>
 #include <boost/iterator/transform_iterator.hpp>
 
 namespace nfd {
@@ -62,6 +68,16 @@ namespace cs {
 class Cs : noncopyable
 {
 public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
   explicit
   Cs(size_t nMaxPackets = 10);
 
@@ -93,6 +109,14 @@ public:
     return m_table.size();
   }
 
+  /** \brief get total size of stored packets (in octets of Data wire encoding)
+   */
+  size_t
+  byteSize() const
+  {
+    return m_nBytes;
+  }
+
 public: // configuration
   /** \brief get capacity (in number of packets)
    */
@@ -110,6 +134,24 @@ public: // configuration
     return m_policy->setLimit(nMaxPackets);
   }
 
+  /** \brief get capacity (in octets of Data wire encoding)
+   */
+  size_t
+  getByteLimit() const
+  {
+    return m_policy->getByteLimit();
+  }
+
+  /** \brief change capacity (in octets of Data wire encoding)
+   *
+   *  The byte limit applies in addition to the capacity in number of packets.
+   */
+  void
+  setByteLimit(size_t nMaxBytes)
+  {
+    return m_policy->setByteLimit(nMaxBytes);
+  }
+
   /** \brief get replacement policy
    */
   Policy*
@@ -119,11 +161,52 @@ public: // configuration
   }
 
   /** \brief change replacement policy
-   *  \pre size() == 0
+   *
+   *  Existing entries are kept: the new policy is loaded with all of them in one pass,
+   *  from the least to the most recently inserted or refreshed, so that it starts with
+   *  a warm cache, with each entry's score under the previous policy (see Policy::getEntryScore).
+   *  Limits and the low watermark of the previous policy carry over to the new policy.
    */
   void
   setPolicy(unique_ptr<Policy> policy);
 
+  /** \brief get admission filter, or nullptr if every Data is admitted
+   */
+  AdmissionFilter*
+  getAdmissionFilter() const
+  {
+    return m_admissionFilter.get();
+  }
+
+  /** \brief change admission filter
+   *  \param filter the filter, or nullptr to admit every Data
+   *
+   *  The filter records the Name of every lookup. When inserting a new Data packet would make
+   *  the replacement policy evict an entry, the Data is inserted only if the filter prefers it
+   *  over that entry.
+   *  Only the first victim is compared: when a low watermark or the byte limit makes the policy
+   *  evict several entries for one insertion, the others are evicted without consulting the filter.
+   */
+  void
+  setAdmissionFilter(unique_ptr<AdmissionFilter> filter);
+
+  /** \brief get cache decision, or nullptr if every Data is cached (leave-copy-everywhere)
+   */
+  CacheDecision*
+  getCacheDecision() const
+  {
+    return m_cacheDecision.get();
+  }
+
+  /** \brief change cache decision
+   *  \param decision the cache decision, or nullptr to cache every Data
+   *
+   *  The decision is consulted before each insertion, and is notified before cached Data
+   *  satisfies an Interest.
+   */
+  void
+  setCacheDecision(unique_ptr<CacheDecision> decision);
+
   /** \brief get CS_ENABLE_ADMIT flag
    *  \sa https://redmine.named-data.net/projects/nfd/wiki/CsMgmt#Update-config
    */
@@ -154,6 +237,47 @@ public: // configuration
   void
   enableServe(bool shouldServe);
 
+public: // snapshot
+  /** \brief writes every entry, with its replacement policy score, to a snapshot file
+   *  \throw Error the file cannot be written
+   *
+   *  The file is written through a memory mapping. Entries are stored from the least to the most
+   *  recently inserted or refreshed, each with the remaining freshness of its Data, whether it is
+   *  unsolicited, the score reported by Policy::getEntryScore(), and the Data wire encoding.
+   */
+  void
+  saveSnapshot(const std::string& filename) const;
+
+  /** \brief restores entries from a snapshot file written by saveSnapshot()
+   *  \return number of entries restored
+   *  \throw Error the file cannot be read, or is not a valid snapshot
+   *
+   *  Entries are added in bulk and handed to the replacement policy in one pass with their
+   *  scores, so that a policy that reports scores (such as LRFU) resumes its previous order.
+   *  If the snapshot does not fit within the limits, its most recent entries are restored.
+   *  Data already in the ContentStore is not replaced. Restored entries are not counted as
+   *  insertions, and bypass the admission filter and cache decision.
+   */
+  size_t
+  loadSnapshot(const std::string& filename);
+
+public: // statistics
+  /** \brief get counters of this ContentStore
+   */
+  const CsCounters&
+  getCounters() const
+  {
+    return m_counters;
+  }
+
+  /** \brief get per-prefix hit and miss counters
+   *
+   *  Counting starts when the first prefix is added to the returned object.
+   *  Until this method is called, lookups are not counted, and counting costs nothing.
+   */
+  PrefixCounters&
+  getPrefixCounters();
+
 public: // enumeration
   struct EntryFromEntryImpl
   {
@@ -183,6 +307,16 @@ public: // enumeration
   }
 
 private: // find
+  /** \brief find leftmost match among entries whose Name equals Interest Name
+   *  \return the match, or m_table.end() if there is no such entry, or if the leftmost such entry
+   *          cannot satisfy the Interest; the ordered table must be searched in that case
+   *
+   *  Entries whose Name equals Interest Name precede all other entries under Interest Name,
+   *  so a match found here is also the leftmost match in the ordered table.
+   */
+  iterator
+  findExact(const Interest& interest) const;
+
   /** \brief find leftmost match in [first,last)
    *  \return the leftmost match, or last if not found
    */
@@ -204,14 +338,80 @@ private: // find
   void
   setPolicyImpl(unique_ptr<Policy> policy);
 
+  /** \return every entry with its score under the current policy, ordered from the least
+   *          to the most recently inserted or refreshed
+   */
+  std::vector<Policy::LoadedEntry>
+  getEntriesByLastUpdate() const;
+
+  /** \return whether the admission filter accepts \p data
+   *  \pre m_admissionFilter != nullptr
+   *
+   *  Data is always accepted if it does not cause an eviction, or if an entry with the same Name
+   *  exists, because the Data is then most likely a refresh.
+   *  Otherwise, it is compared only with Policy::peekVictim(), even if the insertion evicts more
+   *  entries; Policy does not expose the victims after the first.
+   */
+  bool
+  passesAdmissionFilter(const Data& data) const;
+
+  /** \brief adds an entry to the exact Name index
+   */
+  void
+  insertToIndex(iterator it);
+
+  /** \brief removes an entry from the exact Name index
+   *  \pre the entry is still in the table
+   */
+  void
+  eraseFromIndex(iterator it);
+
+  /** \brief erases an entry from the table and the exact Name index
+   */
+  void
+  eraseEntry(iterator it);
+
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   void
   dump();
 
+private:
+  struct NamePtrHash
+  {
+    size_t
+    operator()(const Name* name) const
+    {
+      return std::hash<Name>()(*name);
+    }
+  };
+
+  struct NamePtrEqual
+  {
+    bool
+    operator()(const Name* x, const Name* y) const
+    {
+      return *x == *y;
+    }
+  };
+
+  /** \brief maps a Data Name to the leftmost entry with that Name
+   *
+   *  The key points to the Name of the Data in the mapped entry.
+   */
+  typedef std::unordered_map<const Name*, iterator, NamePtrHash, NamePtrEqual> ExactIndex;
+
 private:
   Table m_table;
+  ExactIndex m_exactIndex;
+  size_t m_nBytes; ///< total wire size of stored Data
   unique_ptr<Policy> m_policy;
+  unique_ptr<AdmissionFilter> m_admissionFilter;
+  unique_ptr<CacheDecision> m_cacheDecision;
   signal::ScopedConnection m_beforeEvictConnection;
+  signal::ScopedConnection m_beforeEvictBatchConnection;
+
+  mutable CsCounters m_counters; ///< mutable because lookups are counted in find() const
+  unique_ptr<PrefixCounters> m_prefixCounters;
 
   bool m_shouldAdmit; ///< if false, no Data will be admitted
   bool m_shouldServe; ///< if false, all lookups will miss
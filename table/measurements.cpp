@@ -75,7 +75,8 @@ Measurements::get(const fib::Entry& fibEntry)
 Entry&
 Measurements::get(const pit::Entry& pitEntry)
 {
-  name_tree::Entry& nte = m_nameTree.lookup(pitEntry.getName(), true);
+  name_tree::Entry& nte = m_nameTree.lookup(pitEntry.getName(),
+                                            name_tree::getHashes(pitEntry.getInterest()), true);
   return this->get(nte);
 }
 
@@ -92,11 +93,12 @@ Measurements::getParent(const Entry& child)
   return &this->get(*nte);
 }
 
-template<typename K>
+template<typename K, typename... H>
 Entry*
-Measurements::findLongestPrefixMatchImpl(const K& key, const EntryPredicate& pred) const
+Measurements::findLongestPrefixMatchImpl(const K& key, const EntryPredicate& pred,
+                                         const H&... hashes) const
 {
-  name_tree::Entry* match = m_nameTree.findLongestPrefixMatch(key,
+  name_tree::Entry* match = m_nameTree.findLongestPrefixMatch(key, hashes...,
     [&pred] (const name_tree::Entry& nte) {
       const Entry* entry = nte.getMeasurementsEntry();
       return entry != nullptr && pred(*entry);
@@ -116,7 +118,9 @@ Measurements::findLongestPrefixMatch(const Name& name, const EntryPredicate& pre
 Entry*
 Measurements::findLongestPrefixMatch(const pit::Entry& pitEntry, const EntryPredicate& pred) const
 {
-  return this->findLongestPrefixMatch(pitEntry.getName(), pred);
+  // the Interest Name starts with the depth-limited prefix, so its hash values can be reused
+  return this->findLongestPrefixMatchImpl(pitEntry.getName().getPrefix(NameTree::getMaxDepth()),
+                                          pred, name_tree::getHashes(pitEntry.getInterest()));
 }
 
 Entry*
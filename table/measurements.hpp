@@ -137,10 +137,11 @@ private:
   get(name_tree::Entry& nte);
 
   /** \tparam K a parameter acceptable to NameTree::findLongestPrefixMatch
+   *  \param hashes optional precomputed hash values of \p key, if \p key is a Name
    */
-  template<typename K>
+  template<typename K, typename... H>
   Entry*
-  findLongestPrefixMatchImpl(const K& key, const EntryPredicate& pred) const;
+  findLongestPrefixMatchImpl(const K& key, const EntryPredicate& pred, const H&... hashes) const;
 
 private:
   NameTree& m_nameTree;
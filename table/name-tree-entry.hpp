@@ -31,6 +31,8 @@
 #include "table/measurements-entry.hpp"
 #include "table/strategy-choice-entry.hpp"
 
+#include <boost/container/small_vector.hpp>
+
 namespace nfd {
 namespace name_tree {
 
@@ -41,6 +43,18 @@ class Node;
 class Entry : noncopyable
 {
 public:
+  /** \brief container of children
+   *
+   *  Most entries have few children, which are stored inline without a separate allocation.
+   */
+  using ChildList = boost::container::small_vector<Entry*, 2>;
+
+  /** \brief container of attached PIT entries
+   *
+   *  An entry usually has at most one PIT entry, which is stored inline.
+   */
+  using PitEntryList = boost::container::small_vector<shared_ptr<pit::Entry>, 1>;
+
   Entry(const Name& prefix, Node* node);
 
   const Name&
@@ -85,7 +99,7 @@ public:
 
   /** \return children of this entry
    */
-  const std::vector<Entry*>&
+  const ChildList&
   getChildren() const
   {
     return m_children;
@@ -122,7 +136,7 @@ public: // attached table entries
     return !this->getPitEntries().empty();
   }
 
-  const std::vector<shared_ptr<pit::Entry>>&
+  const PitEntryList&
   getPitEntries() const
   {
     return m_pitEntries;
@@ -168,10 +182,10 @@ private:
   Name m_name;
   Node* m_node;
   Entry* m_parent;
-  std::vector<Entry*> m_children;
+  ChildList m_children;
 
   unique_ptr<fib::Entry> m_fibEntry;
-  std::vector<shared_ptr<pit::Entry>> m_pitEntries;
+  PitEntryList m_pitEntries;
   unique_ptr<measurements::Entry> m_measurementsEntry;
   unique_ptr<strategy_choice::Entry> m_strategyChoiceEntry;
 
@@ -91,18 +91,10 @@ computeHashes(const Name& name, size_t prefixLen)
 
 Node::Node(HashValue h, const Name& name)
   : hash(h)
-  , prev(nullptr)
-  , next(nullptr)
   , entry(name, this)
 {
 }
 
-Node::~Node()
-{
-  BOOST_ASSERT(prev == nullptr);
-  BOOST_ASSERT(next == nullptr);
-}
-
 Node*
 getNode(const Entry& entry)
 {
@@ -116,92 +108,165 @@ HashtableOptions::HashtableOptions(size_t size)
 }
 
 Hashtable::Hashtable(const Options& options)
-  : m_options(options)
+  : m_migrationIndex(0)
+  , m_options(options)
   , m_size(0)
+  , m_nChangesSinceResize(0)
 {
   BOOST_ASSERT(m_options.minSize > 0);
   BOOST_ASSERT(m_options.initialSize >= m_options.minSize);
   BOOST_ASSERT(m_options.expandLoadFactor > 0.0);
-  BOOST_ASSERT(m_options.expandLoadFactor <= 1.0);
+  BOOST_ASSERT(m_options.expandLoadFactor < 1.0);
   BOOST_ASSERT(m_options.expandFactor > 1.0);
   BOOST_ASSERT(m_options.shrinkLoadFactor >= 0.0);
   BOOST_ASSERT(m_options.shrinkLoadFactor < 1.0);
   BOOST_ASSERT(m_options.shrinkFactor > 0.0);
   BOOST_ASSERT(m_options.shrinkFactor < 1.0);
+  // a shrunk hashtable must not be full
+  BOOST_ASSERT(m_options.shrinkLoadFactor < m_options.expandLoadFactor * m_options.shrinkFactor ||
+               m_options.shrinkLoadFactor == 0.0);
 
-  m_buckets.resize(options.initialSize);
+  m_buckets.resize(options.initialSize, Bucket{0, nullptr});
   this->computeThresholds();
 }
 
 Hashtable::~Hashtable()
 {
-  for (size_t i = 0; i < m_buckets.size(); ++i) {
-    foreachNode(m_buckets[i], [] (Node* node) {
-      node->prev = node->next = nullptr;
-      delete node;
-    });
+  for (const Buckets* buckets : {&m_oldBuckets, &m_buckets}) {
+    for (const Bucket& bucket : *buckets) {
+      if (bucket.node != nullptr) {
+        m_nodePool.destroy(bucket.node);
+      }
+    }
   }
 }
 
-void
-Hashtable::attach(size_t bucket, Node* node)
+const Node*
+Hashtable::getNextNode(const Node* node) const
 {
-  node->prev = nullptr;
-  node->next = m_buckets[bucket];
+  // nodes not yet moved by a resize are enumerated before the resized bucket array
+  const Buckets* buckets = &m_oldBuckets;
+  size_t bucket = 0;
+  if (node != nullptr) {
+    bucket = locate(m_buckets, node);
+    if (bucket < m_buckets.size()) {
+      buckets = &m_buckets;
+    }
+    else {
+      bucket = locate(m_oldBuckets, node);
+      BOOST_ASSERT(bucket < m_oldBuckets.size());
+    }
+    ++bucket;
+  }
+
+  while (true) {
+    for (; bucket < buckets->size(); ++bucket) {
+      if ((*buckets)[bucket].node != nullptr) {
+        return (*buckets)[bucket].node;
+      }
+    }
+    if (buckets == &m_buckets) {
+      return nullptr;
+    }
+    buckets = &m_buckets;
+    bucket = 0;
+  }
+}
 
-  if (node->next != nullptr) {
-    BOOST_ASSERT(node->next->prev == nullptr);
-    node->next->prev = node;
+Node*
+Hashtable::probe(const Buckets& buckets, const Name& name, size_t prefixLen, HashValue h)
+{
+  if (buckets.empty()) {
+    return nullptr;
   }
 
-  m_buckets[bucket] = node;
+  // a node that is closer to its bucket than the probe distance means the name is absent,
+  // because insertion would have placed the name before that node
+  size_t bucket = h % buckets.size();
+  for (size_t distance = 0; buckets[bucket].node != nullptr &&
+                            computeDistance(buckets, bucket) >= distance; ++distance) {
+    const Bucket& b = buckets[bucket];
+    if (b.hash == h && name.compare(0, prefixLen, b.node->entry.getName()) == 0) {
+      return b.node;
+    }
+    bucket = nextBucket(buckets, bucket);
+  }
+  return nullptr;
 }
 
-void
-Hashtable::detach(size_t bucket, Node* node)
+size_t
+Hashtable::locate(const Buckets& buckets, const Node* node)
 {
-  if (node->prev != nullptr) {
-    BOOST_ASSERT(node->prev->next == node);
-    node->prev->next = node->next;
+  if (buckets.empty()) {
+    return 0;
   }
-  else {
-    BOOST_ASSERT(m_buckets[bucket] == node);
-    m_buckets[bucket] = node->next;
+
+  size_t bucket = node->hash % buckets.size();
+  for (size_t distance = 0; buckets[bucket].node != nullptr &&
+                            computeDistance(buckets, bucket) >= distance; ++distance) {
+    if (buckets[bucket].node == node) {
+      return bucket;
+    }
+    bucket = nextBucket(buckets, bucket);
   }
+  return buckets.size();
+}
 
-  if (node->next != nullptr) {
-    BOOST_ASSERT(node->next->prev == node);
-    node->next->prev = node->prev;
+void
+Hashtable::attach(Buckets& buckets, Node* node)
+{
+  Bucket carried{node->hash, node};
+  size_t bucket = carried.hash % buckets.size();
+  size_t distance = 0;
+
+  while (buckets[bucket].node != nullptr) {
+    size_t occupantDistance = computeDistance(buckets, bucket);
+    if (occupantDistance < distance) {
+      // Robin Hood: the occupant is closer to its bucket, so it moves on instead
+      std::swap(carried, buckets[bucket]);
+      distance = occupantDistance;
+    }
+    bucket = nextBucket(buckets, bucket);
+    ++distance;
   }
+  buckets[bucket] = carried;
+}
 
-  node->prev = node->next = nullptr;
+void
+Hashtable::detach(Buckets& buckets, size_t bucket)
+{
+  size_t next = nextBucket(buckets, bucket);
+  while (buckets[next].node != nullptr && computeDistance(buckets, next) > 0) {
+    buckets[bucket] = buckets[next];
+    bucket = next;
+    next = nextBucket(buckets, next);
+  }
+  buckets[bucket] = Bucket{0, nullptr};
 }
 
 std::pair<const Node*, bool>
 Hashtable::findOrInsert(const Name& name, size_t prefixLen, HashValue h, bool allowInsert)
 {
-  size_t bucket = this->computeBucketIndex(h);
-
-  for (const Node* node = m_buckets[bucket]; node != nullptr; node = node->next) {
-    if (node->hash == h && name.compare(0, prefixLen, node->entry.getName()) == 0) {
-      NFD_LOG_TRACE("found " << name.getPrefix(prefixLen) << " hash=" << h << " bucket=" << bucket);
-      return {node, false};
-    }
+  const Node* found = probe(m_buckets, name, prefixLen, h);
+  if (found == nullptr) {
+    found = probe(m_oldBuckets, name, prefixLen, h);
+  }
+  if (found != nullptr) {
+    NFD_LOG_TRACE("found " << name.getPrefix(prefixLen) << " hash=" << h);
+    return {found, false};
   }
 
   if (!allowInsert) {
-    NFD_LOG_TRACE("not-found " << name.getPrefix(prefixLen) << " hash=" << h << " bucket=" << bucket);
+    NFD_LOG_TRACE("not-found " << name.getPrefix(prefixLen) << " hash=" << h);
     return {nullptr, false};
   }
 
-  Node* node = new Node(h, name.getPrefix(prefixLen));
-  this->attach(bucket, node);
-  NFD_LOG_TRACE("insert " << node->entry.getName() << " hash=" << h << " bucket=" << bucket);
+  Node* node = m_nodePool.construct(h, name.getPrefix(prefixLen));
+  attach(m_buckets, node);
+  NFD_LOG_TRACE("insert " << node->entry.getName() << " hash=" << h <<
+                " bucket=" << locate(m_buckets, node));
   ++m_size;
-
-  if (m_size > m_expandThreshold) {
-    this->resize(static_cast<size_t>(m_options.expandFactor * this->getNBuckets()));
-  }
+  this->afterChange();
 
   return {node, true};
 }
@@ -233,14 +298,35 @@ Hashtable::erase(Node* node)
   BOOST_ASSERT(node != nullptr);
   BOOST_ASSERT(node->entry.getParent() == nullptr);
 
-  size_t bucket = this->computeBucketIndex(node->hash);
-  NFD_LOG_TRACE("erase " << node->entry.getName() << " hash=" << node->hash << " bucket=" << bucket);
-
-  this->detach(bucket, node);
-  delete node;
+  size_t bucket = locate(m_buckets, node);
+  if (bucket < m_buckets.size()) {
+    NFD_LOG_TRACE("erase " << node->entry.getName() << " hash=" << node->hash << " bucket=" << bucket);
+    detach(m_buckets, bucket);
+  }
+  else {
+    bucket = locate(m_oldBuckets, node);
+    BOOST_ASSERT(bucket < m_oldBuckets.size());
+    NFD_LOG_TRACE("erase " << node->entry.getName() << " hash=" << node->hash << " old-bucket=" << bucket);
+    detach(m_oldBuckets, bucket);
+  }
+  m_nodePool.destroy(node);
   --m_size;
+  this->afterChange();
+}
+
+void
+Hashtable::afterChange()
+{
+  ++m_nChangesSinceResize;
+  if (this->isResizing()) {
+    this->migrate(m_options.rehashStep);
+  }
 
-  if (m_size < m_shrinkThreshold) {
+  if (m_size > m_expandThreshold) {
+    this->resize(static_cast<size_t>(m_options.expandFactor * this->getNBuckets()));
+  }
+  else if (m_size < m_shrinkThreshold && !this->isResizing() &&
+           m_nChangesSinceResize >= m_options.shrinkDelay) {
     size_t newNBuckets = std::max(m_options.minSize,
       static_cast<size_t>(m_options.shrinkFactor * this->getNBuckets()));
     this->resize(newNBuckets);
@@ -261,20 +347,46 @@ Hashtable::resize(size_t newNBuckets)
   if (this->getNBuckets() == newNBuckets) {
     return;
   }
+
+  if (this->isResizing()) {
+    // Options::rehashStep is too small for the rate of change; nodes must be moved at once
+    NFD_LOG_DEBUG("resize-complete remaining=" << m_oldBuckets.size() - m_migrationIndex);
+    this->migrate(std::numeric_limits<size_t>::max());
+  }
+
   NFD_LOG_DEBUG("resize from=" << this->getNBuckets() << " to=" << newNBuckets);
+  BOOST_ASSERT(newNBuckets > m_size);
 
-  std::vector<Node*> oldBuckets;
-  oldBuckets.swap(m_buckets);
-  m_buckets.resize(newNBuckets);
+  m_oldBuckets.swap(m_buckets);
+  m_buckets.assign(newNBuckets, Bucket{0, nullptr});
+  m_migrationIndex = 0;
+  m_nChangesSinceResize = 0;
+  this->computeThresholds();
 
-  for (Node* head : oldBuckets) {
-    foreachNode(head, [this] (Node* node) {
-      size_t bucket = this->computeBucketIndex(node->hash);
-      this->attach(bucket, node);
-    });
+  this->migrate(m_options.rehashStep == 0 ? std::numeric_limits<size_t>::max() :
+                                            m_options.rehashStep);
+}
+
+void
+Hashtable::migrate(size_t nBuckets)
+{
+  for (; nBuckets > 0 && m_migrationIndex < m_oldBuckets.size(); --nBuckets) {
+    Node* node = m_oldBuckets[m_migrationIndex].node;
+    if (node == nullptr) {
+      ++m_migrationIndex;
+      continue;
+    }
+
+    // detaching may shift the next displaced node into this bucket, so it is visited again
+    attach(m_buckets, node);
+    detach(m_oldBuckets, m_migrationIndex);
   }
 
-  this->computeThresholds();
+  if (m_migrationIndex == m_oldBuckets.size()) {
+    NFD_LOG_TRACE("resize-done nBuckets=" << this->getNBuckets());
+    Buckets().swap(m_oldBuckets);
+    m_migrationIndex = 0;
+  }
 }
 
 } // namespace name_tree
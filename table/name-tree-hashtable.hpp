@@ -27,6 +27,9 @@
 #define NFD_DAEMON_TABLE_NAME_TREE_HASHTABLE_HPP
 
 #include "name-tree-entry.hpp"
+#include "object-pool.hpp"
+
+#include <ndn-cxx/tag.hpp>
 
 namespace nfd {
 namespace name_tree {
@@ -53,10 +56,40 @@ computeHash(const Name& name, size_t prefixLen = std::numeric_limits<size_t>::ma
 HashSequence
 computeHashes(const Name& name, size_t prefixLen = std::numeric_limits<size_t>::max());
 
+/** \brief a packet tag that caches computeHashes() of the packet Name
+ *
+ *  The tag type id must differ from every other tag on the same packet: ndn-cxx numbers its
+ *  lp tags from 10, and ndnSIM uses 0x60000000 and up (HopCountTag, GeoTag).
+ *  This tag takes 0x70000000, outside both ranges.
+ *  \sa getHashes
+ */
+typedef ndn::SimpleTag<HashSequence, 0x70000000> HashSequenceTag;
+
+/** \brief computes hash values for each prefix of the Name of an Interest or Data
+ *  \return computeHashes(packet.getName())
+ *
+ *  The hash sequence is computed at most once per packet, and cached in a HashSequenceTag,
+ *  so that every table lookup made for the packet can reuse it.
+ *  \warning The Name of the packet must not change after this function is called.
+ */
+template<typename Packet>
+const HashSequence&
+getHashes(const Packet& packet)
+{
+  shared_ptr<HashSequenceTag> tag = packet.template getTag<HashSequenceTag>();
+  if (tag == nullptr) {
+    tag = make_shared<HashSequenceTag>(computeHashes(packet.getName()));
+    packet.setTag(tag);
+  }
+  BOOST_ASSERT(tag->get().size() == packet.getName().size() + 1);
+  return tag->get();
+}
+
 /** \brief a hashtable node
  *
- *  Zero or more nodes can be added to a hashtable bucket. They are organized as
- *  a doubly linked list through prev and next pointers.
+ *  A node is referenced from a hashtable slot. Its address does not change while it is in
+ *  the hashtable, even if the slot referencing it moves.
+ *  Nodes are allocated from a pool owned by the hashtable.
  */
 class Node : noncopyable
 {
@@ -66,15 +99,8 @@ public:
    */
   Node(HashValue h, const Name& name);
 
-  /** \pre prev == nullptr
-   *  \pre next == nullptr
-   */
-  ~Node();
-
 public:
   const HashValue hash;
-  Node* prev;
-  Node* next;
   mutable Entry entry;
 };
 
@@ -84,23 +110,6 @@ public:
 Node*
 getNode(const Entry& entry);
 
-/** \brief invoke a function for each node in a doubly linked list
- *  \tparam N either Node or const Node
- *  \tparam F a functor with signature void F(N*)
- *  \note It's safe to delete the node in the function.
- */
-template<typename N, typename F>
-void
-foreachNode(N* head, const F& func)
-{
-  N* node = head;
-  while (node != nullptr) {
-    N* next = node->next;
-    func(node);
-    node = next;
-  }
-}
-
 /** \brief provides options for Hashtable
  */
 class HashtableOptions
@@ -123,6 +132,8 @@ public:
   size_t minSize;
 
   /** \brief if hashtable has more than nBuckets*expandLoadFactor nodes, it will be expanded
+   *
+   *  Each bucket holds at most one node, so this must be less than 1.
    */
   float expandLoadFactor = 0.5;
 
@@ -137,14 +148,39 @@ public:
   /** \brief when hashtable is shrunk, its new size is max(nBuckets*shrinkFactor, minSize)
    */
   float shrinkFactor = 0.5;
+
+  /** \brief number of old buckets whose nodes are moved, per insertion or erasure, while the
+   *         hashtable is being resized
+   *
+   *  0 moves every node at once when the hashtable is resized.
+   */
+  size_t rehashStep = 8;
+
+  /** \brief after a resize, hashtable is not shrunk until there have been at least this many
+   *         insertions and erasures
+   *
+   *  This keeps a hashtable whose size hovers around the shrink threshold from being
+   *  shrunk and expanded repeatedly. Expansion is never delayed.
+   */
+  size_t shrinkDelay = 1024;
 };
 
 /** \brief a hashtable for fast exact name lookup
  *
- *  The Hashtable contains a number of buckets.
- *  Each node is placed into a bucket determined by a hash value computed from its name.
- *  Hash collision is resolved through a doubly linked list in each bucket.
+ *  The Hashtable is an array of buckets, each holding at most one node.
+ *  Hash collision is resolved by open addressing with Robin Hood linear probing: a node is
+ *  placed at or after the bucket determined by its hash value, and on insertion a node that is
+ *  closer to its own bucket yields its place to one that is farther from its bucket.
+ *  This bounds the variance of probe lengths, and lets an unsuccessful lookup stop as soon as
+ *  it reaches a node closer to its bucket than the lookup has probed.
+ *
+ *  Each bucket stores the hash value next to the node pointer, so that a probe compares
+ *  hash values within the bucket array, and dereferences a node only on a hash match.
+ *
  *  The number of buckets is adjusted according to how many nodes are stored.
+ *  Resizing is incremental: a new bucket array is allocated, and each later insertion or
+ *  erasure moves the nodes of Options::rehashStep buckets from the old array to the new one.
+ *  Until every node is moved, lookups probe both arrays.
  */
 class Hashtable
 {
@@ -167,6 +203,7 @@ public:
   }
 
   /** \return number of buckets
+   *  \note During a resize, this is the number of buckets after the resize.
    */
   size_t
   getNBuckets() const
@@ -174,7 +211,15 @@ public:
     return m_buckets.size();
   }
 
-  /** \return bucket index for hash value h
+  /** \return whether nodes are being moved to a resized bucket array
+   */
+  bool
+  isResizing() const
+  {
+    return !m_oldBuckets.empty();
+  }
+
+  /** \return bucket index for hash value h, where probing for a node with that hash starts
    */
   size_t
   computeBucketIndex(HashValue h) const
@@ -182,16 +227,24 @@ public:
     return h % this->getNBuckets();
   }
 
-  /** \return i-th bucket
+  /** \return node in i-th bucket, or nullptr if the bucket is empty
    *  \pre bucket < getNBuckets()
+   *  \note During a resize, nodes not yet moved to the resized bucket array are not returned.
    */
   const Node*
   getBucket(size_t bucket) const
   {
     BOOST_ASSERT(bucket < this->getNBuckets());
-    return m_buckets[bucket]; // don't use m_bucket.at() for better performance
+    return m_buckets[bucket].node; // don't use m_bucket.at() for better performance
   }
 
+  /** \return the first node in bucket order after \p node, or the first node if \p node is
+   *          nullptr; nullptr if there are no more nodes
+   *  \pre node is nullptr or exists in this hashtable
+   */
+  const Node*
+  getNextNode(const Node* node) const;
+
   /** \brief find node for name.getPrefix(prefixLen)
    *  \pre name.size() > prefixLen
    */
@@ -219,15 +272,53 @@ public:
   erase(Node* node);
 
 private:
-  /** \brief attach node to bucket
+  /** \brief a bucket; node == nullptr if the bucket is empty
    */
-  void
-  attach(size_t bucket, Node* node);
+  struct Bucket
+  {
+    HashValue hash;
+    Node* node;
+  };
 
-  /** \brief detach node from bucket
+  typedef std::vector<Bucket> Buckets;
+
+  /** \return distance of the node in a non-empty bucket from the bucket where its probing starts
    */
-  void
-  detach(size_t bucket, Node* node);
+  static size_t
+  computeDistance(const Buckets& buckets, size_t bucket)
+  {
+    size_t home = buckets[bucket].hash % buckets.size();
+    return bucket >= home ? bucket - home : bucket + buckets.size() - home;
+  }
+
+  /** \return the bucket after \p bucket, wrapping around to the first bucket
+   */
+  static size_t
+  nextBucket(const Buckets& buckets, size_t bucket)
+  {
+    return ++bucket == buckets.size() ? 0 : bucket;
+  }
+
+  /** \return node for name.getPrefix(prefixLen) in \p buckets, or nullptr if it does not exist
+   */
+  static Node*
+  probe(const Buckets& buckets, const Name& name, size_t prefixLen, HashValue h);
+
+  /** \return index of the bucket referencing \p node, or buckets.size() if no bucket does
+   */
+  static size_t
+  locate(const Buckets& buckets, const Node* node);
+
+  /** \brief attach node to a bucket array, displacing nodes closer to their buckets
+   *  \pre there is at least one empty bucket
+   */
+  static void
+  attach(Buckets& buckets, Node* node);
+
+  /** \brief detach node from bucket, shifting the following displaced nodes back by one bucket
+   */
+  static void
+  detach(Buckets& buckets, size_t bucket);
 
   std::pair<const Node*, bool>
   findOrInsert(const Name& name, size_t prefixLen, HashValue h, bool allowInsert);
@@ -235,15 +326,33 @@ private:
   void
   computeThresholds();
 
+  /** \brief starts moving every node to a new bucket array of \p newNBuckets buckets
+   *
+   *  A resize in progress is completed first.
+   */
   void
   resize(size_t newNBuckets);
 
+  /** \brief moves the nodes of up to \p nBuckets old buckets to the resized bucket array
+   */
+  void
+  migrate(size_t nBuckets);
+
+  /** \brief invoked after a node is inserted or erased
+   */
+  void
+  afterChange();
+
 private:
-  std::vector<Node*> m_buckets;
+  ObjectPool<Node> m_nodePool;
+  Buckets m_buckets;
+  Buckets m_oldBuckets; ///< buckets before the resize in progress, or empty
+  size_t m_migrationIndex; ///< first old bucket whose nodes may not have been moved yet
   Options m_options;
   size_t m_size;
   size_t m_expandThreshold;
   size_t m_shrinkThreshold;
+  size_t m_nChangesSinceResize; ///< insertions and erasures since the last resize
 };
 
 } // namespace name_tree
@@ -37,16 +37,24 @@ NFD_LOG_INIT("NameTree");
 
 NameTree::NameTree(size_t nBuckets)
   : m_ht(HashtableOptions(nBuckets))
+  , m_lpmMode(LpmMode::LINEAR)
 {
 }
 
 Entry&
 NameTree::lookup(const Name& name, bool enforceMaxDepth)
+{
+  size_t depth = enforceMaxDepth ? std::min(name.size(), getMaxDepth()) : name.size();
+  return this->lookup(name, computeHashes(name, depth), enforceMaxDepth);
+}
+
+Entry&
+NameTree::lookup(const Name& name, const HashSequence& hashes, bool enforceMaxDepth)
 {
   NFD_LOG_TRACE("lookup " << name);
   size_t depth = enforceMaxDepth ? std::min(name.size(), getMaxDepth()) : name.size();
+  BOOST_ASSERT(hashes.size() > depth);
 
-  HashSequence hashes = computeHashes(name, depth);
   const Node* node = nullptr;
   Entry* parent = nullptr;
 
@@ -152,10 +160,29 @@ NameTree::findExactMatch(const Name& name, size_t prefixLen) const
   return node == nullptr ? nullptr : &node->entry;
 }
 
+Entry*
+NameTree::findExactMatch(const Name& name, const HashSequence& hashes, size_t prefixLen) const
+{
+  const Node* node = m_ht.find(name, std::min(name.size(), prefixLen), hashes);
+  return node == nullptr ? nullptr : &node->entry;
+}
+
 Entry*
 NameTree::findLongestPrefixMatch(const Name& name, const EntrySelector& entrySelector) const
 {
-  HashSequence hashes = computeHashes(name);
+  return this->findLongestPrefixMatch(name, computeHashes(name), entrySelector);
+}
+
+Entry*
+NameTree::findLongestPrefixMatch(const Name& name, const HashSequence& hashes,
+                                 const EntrySelector& entrySelector) const
+{
+  BOOST_ASSERT(hashes.size() > name.size());
+
+  if (m_lpmMode == LpmMode::BINARY_SEARCH) {
+    Entry* longest = this->findLongestPrefixByBinarySearch(name, hashes);
+    return longest == nullptr ? nullptr : this->findLongestPrefixMatch(*longest, entrySelector);
+  }
 
   for (ssize_t prefixLen = name.size(); prefixLen >= 0; --prefixLen) {
     const Node* node = m_ht.find(name, prefixLen, hashes);
@@ -167,6 +194,38 @@ NameTree::findLongestPrefixMatch(const Name& name, const EntrySelector& entrySel
   return nullptr;
 }
 
+Entry*
+NameTree::findLongestPrefixByBinarySearch(const Name& name, const HashSequence& hashes) const
+{
+  // the full name is often in the name tree, e.g. when it has a PIT entry
+  const Node* node = m_ht.find(name, name.size(), hashes);
+  if (node != nullptr) {
+    return &node->entry;
+  }
+
+  node = m_ht.find(name, 0, hashes);
+  if (node == nullptr) {
+    return nullptr;
+  }
+
+  // prefix of length lo is in the name tree, and prefix of length hi is not
+  size_t lo = 0;
+  size_t hi = name.size();
+  while (hi - lo > 1) {
+    size_t mid = lo + (hi - lo) / 2;
+    const Node* found = m_ht.find(name, mid, hashes);
+    if (found != nullptr) {
+      lo = mid;
+      node = found;
+    }
+    else {
+      hi = mid;
+    }
+  }
+  NFD_LOG_TRACE("lpm-binary-search " << name << " longest=" << lo);
+  return &node->entry;
+}
+
 Entry*
 NameTree::findLongestPrefixMatch(const Entry& entry1, const EntrySelector& entrySelector) const
 {
@@ -213,6 +272,14 @@ NameTree::findAllMatches(const Name& name, const EntrySelector& entrySelector) c
   return {Iterator(make_shared<PrefixMatchImpl>(*this, entrySelector), entry), end()};
 }
 
+boost::iterator_range<NameTree::const_iterator>
+NameTree::findAllMatches(const Name& name, const HashSequence& hashes,
+                         const EntrySelector& entrySelector) const
+{
+  Entry* entry = this->findLongestPrefixMatch(name, hashes, entrySelector);
+  return {Iterator(make_shared<PrefixMatchImpl>(*this, entrySelector), entry), end()};
+}
+
 boost::iterator_range<NameTree::const_iterator>
 NameTree::fullEnumerate(const EntrySelector& entrySelector) const
 {
@@ -39,6 +39,40 @@ public:
   explicit
   NameTree(size_t nBuckets = 1024);
 
+public: // configuration
+  /** \brief how findLongestPrefixMatch(const Name&) locates the longest prefix in the name tree
+   */
+  enum class LpmMode {
+    /** \brief probe the hashtable for every prefix length, from the longest to the shortest
+     */
+    LINEAR,
+    /** \brief probe the full name, then binary-search on prefix length
+     *
+     *  Every ancestor of a name tree entry is also an entry, so if a prefix is in the name tree,
+     *  all shorter prefixes are too; the entries themselves serve as markers for the search.
+     *  Once the longest prefix in the name tree is found, shorter matches are reached through
+     *  parent pointers without hashtable probes. A name with n components takes at most
+     *  2 + log2(n) probes.
+     */
+    BINARY_SEARCH
+  };
+
+  LpmMode
+  getLpmMode() const
+  {
+    return m_lpmMode;
+  }
+
+  /** \brief sets how findLongestPrefixMatch(const Name&) locates the longest prefix
+   *
+   *  Both modes return the same entry. findAllMatches(const Name&) is affected as well.
+   */
+  void
+  setLpmMode(LpmMode mode)
+  {
+    m_lpmMode = mode;
+  }
+
 public: // information
   /** \brief Maximum depth of the name tree.
    *
@@ -93,6 +127,13 @@ public: // mutation
   Entry&
   lookup(const Name& name, bool enforceMaxDepth = false);
 
+  /** \brief equivalent to .lookup(name, enforceMaxDepth), with precomputed hash values
+   *  \param hashes computeHashes(name), or hash values of a longer name that starts with \p name
+   *  \note This overload avoids hashing \p name again, e.g. with getHashes(interest).
+   */
+  Entry&
+  lookup(const Name& name, const HashSequence& hashes, bool enforceMaxDepth = false);
+
   /** \brief equivalent to .lookup(fibEntry.getPrefix())
    *  \param fibEntry a FIB entry attached to this name tree, or Fib::s_emptyEntry
    *  \note This overload is more efficient than .lookup(const Name&) in common cases.
@@ -141,6 +182,13 @@ public: // matching
   Entry*
   findExactMatch(const Name& name, size_t prefixLen = std::numeric_limits<size_t>::max()) const;
 
+  /** \brief equivalent to .findExactMatch(name, prefixLen), with precomputed hash values
+   *  \param hashes computeHashes(name)
+   */
+  Entry*
+  findExactMatch(const Name& name, const HashSequence& hashes,
+                 size_t prefixLen = std::numeric_limits<size_t>::max()) const;
+
   /** \brief longest prefix matching
    *  \return entry whose name is a prefix of \p name and passes \p entrySelector,
    *          where no other entry with a longer name satisfies those requirements;
@@ -150,6 +198,14 @@ public: // matching
   findLongestPrefixMatch(const Name& name,
                          const EntrySelector& entrySelector = AnyEntry()) const;
 
+  /** \brief equivalent to .findLongestPrefixMatch(name, entrySelector), with precomputed
+   *         hash values
+   *  \param hashes computeHashes(name), or hash values of a longer name that starts with \p name
+   */
+  Entry*
+  findLongestPrefixMatch(const Name& name, const HashSequence& hashes,
+                         const EntrySelector& entrySelector = AnyEntry()) const;
+
   /** \brief equivalent to .findLongestPrefixMatch(entry.getName(), entrySelector)
    *  \note This overload is more efficient than
    *        .findLongestPrefixMatch(const Name&, const EntrySelector&) in common cases.
@@ -206,6 +262,13 @@ public: // matching
   findAllMatches(const Name& name,
                  const EntrySelector& entrySelector = AnyEntry()) const;
 
+  /** \brief equivalent to .findAllMatches(name, entrySelector), with precomputed hash values
+   *  \param hashes computeHashes(name)
+   */
+  Range
+  findAllMatches(const Name& name, const HashSequence& hashes,
+                 const EntrySelector& entrySelector = AnyEntry()) const;
+
 public: // enumeration
   using const_iterator = Iterator;
 
@@ -265,8 +328,17 @@ public: // enumeration
     return Iterator();
   }
 
+private:
+  /** \return entry of the longest prefix of \p name in the name tree, or nullptr if the name tree
+   *          is empty
+   *  \pre hashes[i] == computeHash(name, i) for i <= name.size()
+   */
+  Entry*
+  findLongestPrefixByBinarySearch(const Name& name, const HashSequence& hashes) const;
+
 private:
   Hashtable m_ht;
+  LpmMode m_lpmMode;
 
   friend class EnumerationImpl;
 };
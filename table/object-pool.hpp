@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2018,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NFD_DAEMON_TABLE_OBJECT_POOL_HPP
+#define NFD_DAEMON_TABLE_OBJECT_POOL_HPP
+
+#include "core/common.hpp"
+
+#include <type_traits>
+
+namespace nfd {
+
+/** \brief a pool of objects of type T, allocated in slabs
+ *
+ *  Destroyed objects are kept on a free list and their storage is reused by later
+ *  construct() calls. Once the pool has grown to the working set of a table,
+ *  constructing and destroying objects does not call the system allocator.
+ *  Storage is returned to the system only when the pool is destructed.
+ *
+ *  \warning Objects still alive when the pool is destructed are not destructed.
+ */
+template<typename T>
+class ObjectPool : noncopyable
+{
+public:
+  /** \param nObjectsPerSlab number of objects allocated together when the pool grows
+   */
+  explicit
+  ObjectPool(size_t nObjectsPerSlab = 64)
+    : m_nObjectsPerSlab(nObjectsPerSlab)
+    , m_freeList(nullptr)
+    , m_size(0)
+  {
+    BOOST_ASSERT(nObjectsPerSlab > 0);
+  }
+
+  /** \brief constructs an object in storage taken from the pool
+   */
+  template<typename... Args>
+  T*
+  construct(Args&&... args)
+  {
+    if (m_freeList == nullptr) {
+      this->grow();
+    }
+
+    Slot* slot = m_freeList;
+    m_freeList = slot->next;
+    try {
+      T* obj = new (&slot->storage) T(std::forward<Args>(args)...);
+      ++m_size;
+      return obj;
+    }
+    catch (...) {
+      slot->next = m_freeList;
+      m_freeList = slot;
+      throw;
+    }
+  }
+
+  /** \brief destructs an object and returns its storage to the pool
+   *  \pre obj was constructed by this pool
+   */
+  void
+  destroy(T* obj)
+  {
+    BOOST_ASSERT(obj != nullptr);
+    BOOST_ASSERT(m_size > 0);
+
+    obj->~T();
+    Slot* slot = reinterpret_cast<Slot*>(obj);
+    slot->next = m_freeList;
+    m_freeList = slot;
+    --m_size;
+  }
+
+  /** \return number of live objects
+   */
+  size_t
+  size() const
+  {
+    return m_size;
+  }
+
+  /** \return number of objects that can be held without growing the pool
+   */
+  size_t
+  capacity() const
+  {
+    return m_slabs.size() * m_nObjectsPerSlab;
+  }
+
+private:
+  union Slot
+  {
+    Slot* next;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+  };
+
+  void
+  grow()
+  {
+    m_slabs.emplace_back(new Slot[m_nObjectsPerSlab]);
+    Slot* slab = m_slabs.back().get();
+    for (size_t i = m_nObjectsPerSlab; i > 0; --i) {
+      slab[i - 1].next = m_freeList;
+      m_freeList = &slab[i - 1];
+    }
+  }
+
+private:
+  size_t m_nObjectsPerSlab;
+  std::vector<unique_ptr<Slot[]>> m_slabs;
+  Slot* m_freeList;
+  size_t m_size;
+};
+
+} // namespace nfd
+
+#endif // NFD_DAEMON_TABLE_OBJECT_POOL_HPP
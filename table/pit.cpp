@@ -47,14 +47,15 @@ Pit::findOrInsert(const Interest& interest, bool allowInsert)
   const Name& name = interest.getName();
   bool isEndWithDigest = name.size() > 0 && name[-1].isImplicitSha256Digest();
   const Name& nteName = isEndWithDigest ? name.getPrefix(-1) : name;
+  const name_tree::HashSequence& hashes = name_tree::getHashes(interest);
 
   // ensure NameTree entry exists
   name_tree::Entry* nte = nullptr;
   if (allowInsert) {
-    nte = &m_nameTree.lookup(nteName, true);
+    nte = &m_nameTree.lookup(nteName, hashes, true);
   }
   else {
-    nte = m_nameTree.findExactMatch(nteName);
+    nte = m_nameTree.findExactMatch(nteName, hashes);
     if (nte == nullptr) {
       return {nullptr, true};
     }
@@ -62,7 +63,7 @@ Pit::findOrInsert(const Interest& interest, bool allowInsert)
 
   // check if PIT entry already exists
   size_t nteNameLen = nte->getName().size();
-  const std::vector<shared_ptr<Entry>>& pitEntries = nte->getPitEntries();
+  const name_tree::Entry::PitEntryList& pitEntries = nte->getPitEntries();
   auto it = std::find_if(pitEntries.begin(), pitEntries.end(),
     [&interest, nteNameLen] (const shared_ptr<Entry>& entry) {
       // initial part of name is guaranteed to be equal by NameTree
@@ -87,7 +88,8 @@ Pit::findOrInsert(const Interest& interest, bool allowInsert)
 DataMatchResult
 Pit::findAllDataMatches(const Data& data) const
 {
-  auto&& ntMatches = m_nameTree.findAllMatches(data.getName(), &nteHasPitEntries);
+  auto&& ntMatches = m_nameTree.findAllMatches(data.getName(), name_tree::getHashes(data),
+                                               &nteHasPitEntries);
 
   DataMatchResult matches;
   for (const name_tree::Entry& nte : ntMatches) {